@@ -1,13 +1,12 @@
 
 #include "AutoFishingApp.h"
 #include "resource.h"
-#include <random>
+#include <algorithm>
+#include <ctime>
 #include <sstream>
 #include <iomanip>
 #include <iostream>
 #include <fstream>
-#include <regex>
-#include <ctime>
 #include "nlohmann/json.hpp"
 
 using json = nlohmann::json;
@@ -18,65 +17,26 @@ void joinThreadIfNeeded(std::thread& t) {
         t.join();
     }
 }
-}
-
-// RAII guard using CAS for the protected_ gate
-struct ProtectedGuard {
-    std::atomic<bool>& flag;
-    bool owns;
-    explicit ProtectedGuard(std::atomic<bool>& f) : flag(f), owns(false) {
-        bool expected = false;
-        owns = flag.compare_exchange_strong(expected, true, std::memory_order_acq_rel);
-    }
-    bool acquired() const { return owns; }
-    ~ProtectedGuard() {
-        if (owns) {
-            flag.store(false, std::memory_order_release);
-        }
-    }
-};
 
-struct WorkerGuard {
-    std::atomic<int>& counter;
-    explicit WorkerGuard(std::atomic<int>& c) : counter(c) {
-        counter.fetch_add(1, std::memory_order_relaxed);
-    }
-    ~WorkerGuard() {
-        counter.fetch_sub(1, std::memory_order_relaxed);
+std::wstring formatPhaseMs(double ms) {
+    std::wstringstream ss;
+    if (ms < 1000.0) {
+        ss << static_cast<int>(ms + 0.5) << L"ms";
+    } else {
+        ss << std::fixed << std::setprecision(1) << ms / 1000.0 << L"s";
     }
-};
+    return ss.str();
+}
+}
 
 AutoFishingApp::AutoFishingApp(HWND hwnd)
-    : hwnd(hwnd), running(false), protected_(false), appIsExiting(false),
-      reelTimeoutFlag_(false), firstCast(true),
-      castTime(FishingConfig::DEFAULT_CAST_TIME),
-      restTime(FishingConfig::DEFAULT_REST_TIME),
-      timeoutLimit(FishingConfig::DEFAULT_TIMEOUT_MINUTES),
-      randomCastEnabled(false), randomCastMax(1.0), noCastMode(false),
-      timeoutId(0), reelTimeoutId_(0), castCycleId_(0),
-      pendingBucketCycleId_(0), pendingBucketRetry_(0), pendingBucketSawAttempt_(false),
-      fishPickupDetected_(false), hFont(nullptr) {
-    activeWorkers_ = 0;
+    : hwnd(hwnd), hFont(nullptr), oscClient(nullptr), logHandler(nullptr), cycle_(nullptr),
+      oscServer_(nullptr), oscListenPort_(FishingConfig::DEFAULT_OSC_LISTEN_PORT), appIsExiting(false) {
     uiThreadId_ = GetCurrentThreadId();
     
     // Detect system language
     currentLanguage = detectSystemLanguage();
     
-    stats.reels = 0;
-    stats.timeouts = 0;
-    stats.bucketSuccess = 0;
-    auto nowSteady = std::chrono::steady_clock::now();
-    auto nowWall = std::chrono::system_clock::now();
-    lastCycleEnd = nowSteady;
-    waitHookStartedAt_ = nowSteady;
-    currentCycleStartedAt_ = nowSteady;
-    pendingBucketStartedAt_ = nowSteady;
-    waitHookStartedWallAt_ = nowWall;
-    pendingBucketMinEventAt_ = nowWall;
-    lastBucketSavedAt_ = nowWall - std::chrono::seconds(60);
-    lastHookSavedEventAt_ = nowWall - std::chrono::seconds(60);
-    fishPickupDetectedAt_ = nowSteady;
-    
     // Create a better font for Chinese text display
     hFont = CreateFontW(
         20,                        // Height - increased for better readability
@@ -95,53 +55,59 @@ AutoFishingApp::AutoFishingApp(HWND hwnd)
         L"Microsoft YaHei"         // Facename - good for Chinese
     );
 
-    oscClient = new OSCClient("127.0.0.1", 9000);
+    loadOscTargets();
+    oscClient = new OSCClient(oscTargets_);
     if (!oscClient->initialize()) {
         MessageBoxW(hwnd, L"Initialize OSC Client Failed", L"Error", MB_OK | MB_ICONERROR);
     }
 
-    logHandler = new VRChatLogHandler([this](LogEventType eventType, const std::string& line) {
-        this->onLogEvent(eventType, line);
+    cycle_ = new FishingCycle(clock_, *oscClient);
+    cycle_->setStatusCallback([this](FishingState) { this->updateStatus(); });
+    cycle_->setStatsCallback([this]() { this->updateStats(); });
+
+    logHandler = new VRChatLogHandler(clock_, [this](const LogEvent& event) {
+        if (!appIsExiting) {
+            cycle_->onLogEvent(event);
+        }
+    });
+    cycle_->setRecentEventLookup([this](LogEventType type, std::chrono::system_clock::time_point minTime, uint64_t& cursor) {
+        return logHandler->findRecentEvent(type, minTime, cursor);
     });
     logHandler->startMonitor();
 
-    lastCastTime_ = std::chrono::steady_clock::now() - std::chrono::seconds(10);
-
     createControls();
-    sendClick(false);
+    oscClient->sendClick(false);
 
     loadConfig(); // Load config after creating controls
+    startOscServer();
 
     statsThread = std::thread(&AutoFishingApp::updateStatsLoop, this);
 
     registerHotkeys();
 
-    // Create icons for tray status - English names internally
-    statusIcons["Waiting"] = createColoredIcon(RGB(128, 128, 128)); // Gray
-    statusIcons["Starting"] = createColoredIcon(RGB(255, 165, 0)); // Orange
-    statusIcons["Casting"] = createColoredIcon(RGB(255, 69, 0)); // OrangeRed
-    statusIcons["WaitingFish"] = createColoredIcon(RGB(0, 255, 0)); // Green
-    statusIcons["Reeling"] = createColoredIcon(RGB(255, 215, 0)); // Gold
-    statusIcons["WaitingBucket"] = createColoredIcon(RGB(147, 112, 219)); // MediumPurple
-    statusIcons["Resting"] = createColoredIcon(RGB(135, 206, 235)); // SkyBlue
-    statusIcons["Timeout"] = createColoredIcon(RGB(255, 99, 71)); // Tomato
-    statusIcons["Stopped"] = createColoredIcon(RGB(128, 128, 128)); // Gray
+    // Create icons for tray status, indexed by FishingState
+    static const COLORREF stateColors[kFishingStateCount] = {
+        RGB(128, 128, 128), // Waiting - Gray
+        RGB(255, 165, 0),   // Starting - Orange
+        RGB(255, 69, 0),    // Casting - OrangeRed
+        RGB(0, 255, 0),     // WaitingFish - Green
+        RGB(255, 215, 0),   // Reeling - Gold
+        RGB(147, 112, 219), // WaitingBucket - MediumPurple
+        RGB(135, 206, 235), // Resting - SkyBlue
+        RGB(255, 99, 71),   // Timeout - Tomato
+        RGB(128, 128, 128)  // Stopped - Gray
+    };
+    for (size_t i = 0; i < kFishingStateCount; ++i) {
+        statusIcons[i] = createColoredIcon(stateColors[i]);
+    }
 
     setupTrayIcon();
 }
 
 AutoFishingApp::~AutoFishingApp() {
     appIsExiting = true;
-    running = false;
-    timeoutId++;
-    reelTimeoutId_++;
+    cycle_->shutdown();
     joinThreadIfNeeded(restartThread_);
-    joinThreadIfNeeded(fishingThread);
-    {
-        std::lock_guard<std::mutex> timerLock(timerThreadMutex_);
-        joinThreadIfNeeded(timeoutThread);
-        joinThreadIfNeeded(reelTimeoutThread_);
-    }
     joinThreadIfNeeded(statsThread);
 
     saveConfig();
@@ -151,22 +117,25 @@ AutoFishingApp::~AutoFishingApp() {
         DeleteObject(hFont);
     }
 
-    for (auto const& [key, val] : statusIcons) {
-        DestroyIcon(val);
+    for (HICON icon : statusIcons) {
+        DestroyIcon(icon);
     }
 
     unregisterHotkeys();
     emergencyRelease();
-    
-    for (int i = 0; i < 500 && activeWorkers_.load(std::memory_order_relaxed) > 0; ++i) {
-        Sleep(20);
-    }
 
     if (logHandler) {
         logHandler->stop();
         delete logHandler;
     }
 
+    if (oscServer_) {
+        oscServer_->stop();
+        delete oscServer_;
+    }
+
+    delete cycle_;
+
     if (oscClient) {
         delete oscClient;
     }
@@ -222,10 +191,16 @@ std::wstring AutoFishingApp::getText(const std::string& key) {
                        {Language::English, L"Rest Time:"}}},
         {"timeout_time", {{Language::Chinese, L"\u8d85\u65f6\u65f6\u95f4:"},
                           {Language::English, L"Timeout:"}}},
+        {"adaptive_timeout", {{Language::Chinese, L"\u81ea\u9002\u5e94\u8d85\u65f6\uff08\u6309\u54ac\u94a9\u65f6\u95f4\u767e\u5206\u4f4d\uff09"},
+                              {Language::English, L"Adaptive Timeout (bite-time percentile)"}}},
         {"random_cast", {{Language::Chinese, L"\u968f\u673a\u84c4\u529b\u65f6\u95f4"},
                          {Language::English, L"Random Cast Time"}}},
         {"random_max", {{Language::Chinese, L"\u968f\u673a\u6700\u5927\u503c:"},
                         {Language::English, L"Random Max:"}}},
+        {"cast_optimizer", {{Language::Chinese, L"\u81ea\u52a8\u4f18\u5316\u84c4\u529b\u65f6\u95f4"},
+                            {Language::English, L"Optimize Cast Time"}}},
+        {"best_cast", {{Language::Chinese, L"\u6700\u4f73"},
+                       {Language::English, L"Best"}}},
         {"no_cast_mode", {{Language::Chinese, L"\u65e0\u629b\u7aff\u6a21\u5f0f"},
                           {Language::English, L"No Cast Mode"}}},
         {"start", {{Language::Chinese, L"\u5f00\u59cb"},
@@ -246,6 +221,14 @@ std::wstring AutoFishingApp::getText(const std::string& key) {
                       {Language::English, L"Timeouts:"}}},
         {"runtime", {{Language::Chinese, L"\u8fd0\u884c\u65f6\u95f4:"},
                      {Language::English, L"Runtime:"}}},
+        {"bite_time", {{Language::Chinese, L"\u54ac\u94a9\u65f6\u95f4:"},
+                       {Language::English, L"Bite Time:"}}},
+        {"wait_limit", {{Language::Chinese, L"\u5f53\u524d\u8d85\u65f6:"},
+                        {Language::English, L"Wait Limit:"}}},
+        {"export", {{Language::Chinese, L"\u5bfc\u51fa"},
+                    {Language::English, L"Export"}}},
+        {"export_failed", {{Language::Chinese, L"\u9636\u6bb5\u8017\u65f6\u5199\u5165\u5931\u8d25\u3002"},
+                           {Language::English, L"Failed to write phase timings."}}},
         {"hotkeys", {{Language::Chinese, L"\u5feb\u6377\u952e: Ctrl+F4: \u663e\u793a/\u9690\u85cf  Ctrl+F5: \u5f00\u59cb  Ctrl+F6: \u505c\u6b62  Ctrl+F7: \u91cd\u9493"},
                      {Language::English, L"Hotkeys: Ctrl+F4: Show/Hide  Ctrl+F5: Start  Ctrl+F6: Stop  Ctrl+F7: Restart"}}}
     };
@@ -260,36 +243,41 @@ std::wstring AutoFishingApp::getText(const std::string& key) {
     return L"[Missing: " + std::wstring(key.begin(), key.end()) + L"]";
 }
 
-std::wstring AutoFishingApp::getStatusDisplayText(const std::string& status) {
-    static const std::map<std::string, std::map<Language, std::wstring>> statusMap = {
-        {"Waiting", {{Language::Chinese, L"\u7b49\u5f85"},
-                     {Language::English, L"Waiting"}}},
-        {"Starting", {{Language::Chinese, L"\u5f00\u59cb\u629b\u7aff"},
-                      {Language::English, L"Starting Cast"}}},
-        {"Casting", {{Language::Chinese, L"\u9c7c\u7aff\u84c4\u529b\u4e2d"},
-                     {Language::English, L"Casting"}}},
-        {"WaitingFish", {{Language::Chinese, L"\u7b49\u5f85\u9c7c\u4e0a\u94a9"},
-                         {Language::English, L"Waiting Fish"}}},
-        {"Reeling", {{Language::Chinese, L"\u6536\u7aff\u4e2d"},
-                     {Language::English, L"Reeling"}}},
-        {"WaitingBucket", {{Language::Chinese, L"\u7b49\u5f85\u9c7c\u88c5\u6876"},
-                           {Language::English, L"Waiting Bucket"}}},
-        {"Resting", {{Language::Chinese, L"\u4f11\u606f\u4e2d"},
-                     {Language::English, L"Resting"}}},
-        {"Timeout", {{Language::Chinese, L"\u8d85\u65f6\u6536\u7aff"},
-                     {Language::English, L"Timeout Reel"}}},
-        {"Stopped", {{Language::Chinese, L"\u5df2\u505c\u6b62"},
-                     {Language::English, L"Stopped"}}}
+std::wstring AutoFishingApp::getStatusDisplayText(FishingState state) {
+    // { Chinese, English }, indexed by FishingState
+    static const wchar_t* const statusText[kFishingStateCount][2] = {
+        { L"\u7b49\u5f85", L"Waiting" },
+        { L"\u5f00\u59cb\u629b\u7aff", L"Starting Cast" },
+        { L"\u9c7c\u7aff\u84c4\u529b\u4e2d", L"Casting" },
+        { L"\u7b49\u5f85\u9c7c\u4e0a\u94a9", L"Waiting Fish" },
+        { L"\u6536\u7aff\u4e2d", L"Reeling" },
+        { L"\u7b49\u5f85\u9c7c\u88c5\u6876", L"Waiting Bucket" },
+        { L"\u4f11\u606f\u4e2d", L"Resting" },
+        { L"\u8d85\u65f6\u6536\u7aff", L"Timeout Reel" },
+        { L"\u5df2\u505c\u6b62", L"Stopped" }
     };
-    
-    auto it = statusMap.find(status);
-    if (it != statusMap.end()) {
-        auto langIt = it->second.find(currentLanguage);
-        if (langIt != it->second.end()) {
-            return langIt->second;
-        }
+
+    size_t index = static_cast<size_t>(state);
+    if (index >= kFishingStateCount) {
+        return L"Unknown";
     }
-    return L"Unknown";
+    return statusText[index][currentLanguage == Language::Chinese ? 0 : 1];
+}
+
+std::wstring AutoFishingApp::getPhaseDisplayText(CyclePhase phase) {
+    // { Chinese, English }, indexed by CyclePhase
+    static const wchar_t* const phaseText[kCyclePhaseCount][2] = {
+        { L"\u84c4\u529b", L"Cast Hold" },
+        { L"\u7b49\u5f85\u54ac\u94a9", L"Bite Wait" },
+        { L"\u54ac\u94a9\u5230\u6536\u6746", L"Hook to Press" },
+        { L"\u62fe\u53d6\u68c0\u6d4b", L"Pickup Detect" },
+        { L"\u62fe\u53d6\u7b49\u5f85", L"Pickup Hold" },
+        { L"\u88c5\u6876\u786e\u8ba4", L"Bucket Confirm" },
+        { L"\u8d85\u65f6\u6536\u6746", L"Timeout Reel" },
+        { L"\u4f11\u606f", L"Rest" }
+    };
+
+    return phaseText[static_cast<size_t>(phase)][currentLanguage == Language::Chinese ? 0 : 1];
 }
 
 void AutoFishingApp::createControls() {
@@ -349,6 +337,12 @@ void AutoFishingApp::createControls() {
     if (hFont) SendMessage(hTimeoutLabel, WM_SETFONT, (WPARAM)hFont, TRUE);
     y += 40;
 
+    hAdaptiveTimeoutCheck = CreateWindowW(L"BUTTON", getText("adaptive_timeout").c_str(),
+        WS_CHILD | WS_VISIBLE | BS_AUTOCHECKBOX,
+        10, y, 440, 20, hwnd, (HMENU)IDC_ADAPTIVE_TIMEOUT_CHECK, nullptr, nullptr);
+    if (hFont) SendMessage(hAdaptiveTimeoutCheck, WM_SETFONT, (WPARAM)hFont, TRUE);
+    y += 30;
+
     hRandomCastCheck = CreateWindowW(L"BUTTON", getText("random_cast").c_str(),
         WS_CHILD | WS_VISIBLE | BS_AUTOCHECKBOX,
         10, y, 200, 20, hwnd, (HMENU)IDC_RANDOM_CAST_CHECK, nullptr, nullptr);
@@ -373,7 +367,17 @@ void AutoFishingApp::createControls() {
         WS_CHILD | WS_VISIBLE | SS_RIGHT,
         labelWidth + sliderWidth + 20, y, valueWidth, 20, hwnd, (HMENU)IDC_RANDOM_MAX_LABEL, nullptr, nullptr);
     if (hFont) SendMessage(hRandomMaxLabel, WM_SETFONT, (WPARAM)hFont, TRUE);
-    y += 50;
+    y += 40;
+
+    hCastOptimizerCheck = CreateWindowW(L"BUTTON", getText("cast_optimizer").c_str(),
+        WS_CHILD | WS_VISIBLE | BS_AUTOCHECKBOX,
+        10, y, 200, 20, hwnd, (HMENU)IDC_CAST_OPTIMIZER_CHECK, nullptr, nullptr);
+    if (hFont) SendMessage(hCastOptimizerCheck, WM_SETFONT, (WPARAM)hFont, TRUE);
+    hCastOptimizerLabel = CreateWindowW(L"STATIC", L"",
+        WS_CHILD | WS_VISIBLE | SS_RIGHT,
+        220, y, 230, 20, hwnd, (HMENU)IDC_CAST_OPTIMIZER_LABEL, nullptr, nullptr);
+    if (hFont) SendMessage(hCastOptimizerLabel, WM_SETFONT, (WPARAM)hFont, TRUE);
+    y += 40;
 
     hStartButton = CreateWindowW(L"BUTTON", getText("start").c_str(),
         WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
@@ -439,7 +443,45 @@ void AutoFishingApp::createControls() {
         WS_CHILD | WS_VISIBLE,
         400, y, 100, 20, hwnd, (HMENU)IDC_STATS_RUNTIME, nullptr, nullptr);
     if (hFont) SendMessage(hStatsRuntime, WM_SETFONT, (WPARAM)hFont, TRUE);
-    y += 30;
+    y += 25;
+
+    HWND hBiteTimeLabel = CreateWindowW(L"STATIC", getText("bite_time").c_str(),
+        WS_CHILD | WS_VISIBLE,
+        50, y, 100, 20, hwnd, nullptr, nullptr, nullptr);
+    if (hFont) SendMessage(hBiteTimeLabel, WM_SETFONT, (WPARAM)hFont, TRUE);
+    hStatsBiteTime = CreateWindowW(L"STATIC", L"--",
+        WS_CHILD | WS_VISIBLE,
+        150, y, 150, 20, hwnd, (HMENU)IDC_STATS_BITE_TIME, nullptr, nullptr);
+    if (hFont) SendMessage(hStatsBiteTime, WM_SETFONT, (WPARAM)hFont, TRUE);
+
+    HWND hWaitLimitLabel = CreateWindowW(L"STATIC", getText("wait_limit").c_str(),
+        WS_CHILD | WS_VISIBLE,
+        300, y, 100, 20, hwnd, nullptr, nullptr, nullptr);
+    if (hFont) SendMessage(hWaitLimitLabel, WM_SETFONT, (WPARAM)hFont, TRUE);
+    hStatsWaitLimit = CreateWindowW(L"STATIC", L"1.0min",
+        WS_CHILD | WS_VISIBLE,
+        400, y, 100, 20, hwnd, (HMENU)IDC_STATS_WAIT_LIMIT, nullptr, nullptr);
+    if (hFont) SendMessage(hStatsWaitLimit, WM_SETFONT, (WPARAM)hFont, TRUE);
+    y += 25;
+
+    // p50/p95/p99 of the phase picked in the combo box
+    hPhaseCombo = CreateWindowW(L"COMBOBOX", nullptr,
+        WS_CHILD | WS_VISIBLE | WS_VSCROLL | CBS_DROPDOWNLIST,
+        10, y, 130, 200, hwnd, (HMENU)IDC_PHASE_COMBO, nullptr, nullptr);
+    if (hFont) SendMessage(hPhaseCombo, WM_SETFONT, (WPARAM)hFont, TRUE);
+    for (size_t i = 0; i < kCyclePhaseCount; ++i) {
+        SendMessageW(hPhaseCombo, CB_ADDSTRING, 0, (LPARAM)getPhaseDisplayText(static_cast<CyclePhase>(i)).c_str());
+    }
+    SendMessage(hPhaseCombo, CB_SETCURSEL, static_cast<WPARAM>(CyclePhase::BiteWait), 0);
+    hPhaseLatency = CreateWindowW(L"STATIC", L"--",
+        WS_CHILD | WS_VISIBLE,
+        150, y + 3, 230, 20, hwnd, (HMENU)IDC_PHASE_LATENCY, nullptr, nullptr);
+    if (hFont) SendMessage(hPhaseLatency, WM_SETFONT, (WPARAM)hFont, TRUE);
+    hPhaseExportButton = CreateWindowW(L"BUTTON", getText("export").c_str(),
+        WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+        380, y, 70, 25, hwnd, (HMENU)IDC_PHASE_EXPORT, nullptr, nullptr);
+    if (hFont) SendMessage(hPhaseExportButton, WM_SETFONT, (WPARAM)hFont, TRUE);
+    y += 35;
 
     // Hotkeys information
     HWND hHotkeysLabel = CreateWindowW(L"STATIC", getText("hotkeys").c_str(),
@@ -450,9 +492,8 @@ void AutoFishingApp::createControls() {
     if (hFont) SendMessage(hHotkeysLabel, WM_SETFONT, (WPARAM)hFont, TRUE);
 }
 
-std::string AutoFishingApp::getCurrentAction() const {
-    std::lock_guard<std::mutex> lock(actionMutex_);
-    return currentAction;
+FishingState AutoFishingApp::getState() const {
+    return cycle_->getState();
 }
 
 void AutoFishingApp::onCommand(WPARAM wParam, LPARAM lParam) {
@@ -466,14 +507,37 @@ void AutoFishingApp::onCommand(WPARAM wParam, LPARAM lParam) {
     case IDC_RANDOM_CAST_CHECK:
         if (event == BN_CLICKED) {
             bool enabled = (SendMessage(hRandomCastCheck, BM_GETCHECK, 0, 0) == BST_CHECKED);
-            randomCastEnabled.store(enabled);
-            EnableWindow(hRandomMaxSlider, enabled);
+            cycle_->settings().randomCastEnabled.store(enabled);
+            applyCastOptimizerUI();
+        }
+        break;
+    case IDC_PHASE_COMBO:
+        if (event == CBN_SELCHANGE) {
+            applyStatsUI();
+        }
+        break;
+    case IDC_PHASE_EXPORT:
+        if (event == BN_CLICKED) {
+            exportPhaseReport();
+        }
+        break;
+    case IDC_CAST_OPTIMIZER_CHECK:
+        if (event == BN_CLICKED) {
+            bool enabled = (SendMessage(hCastOptimizerCheck, BM_GETCHECK, 0, 0) == BST_CHECKED);
+            cycle_->settings().castOptimizerEnabled.store(enabled);
+            applyCastOptimizerUI();
+        }
+        break;
+    case IDC_ADAPTIVE_TIMEOUT_CHECK:
+        if (event == BN_CLICKED) {
+            bool enabled = (SendMessage(hAdaptiveTimeoutCheck, BM_GETCHECK, 0, 0) == BST_CHECKED);
+            cycle_->settings().adaptiveTimeout.store(enabled);
         }
         break;
     case IDC_NO_CAST_CHECKBOX:
         if (event == BN_CLICKED) {
             bool enabled = (SendMessage(hNoCastCheckbox, BM_GETCHECK, 0, 0) == BST_CHECKED);
-            noCastMode.store(enabled);
+            cycle_->settings().noCastMode.store(enabled);
 
             // Hide/show cast time related controls
             int showCast = enabled ? SW_HIDE : SW_SHOW;
@@ -484,39 +548,48 @@ void AutoFishingApp::onCommand(WPARAM wParam, LPARAM lParam) {
             ShowWindow(hRandomMaxTitleLabel, showCast);
             ShowWindow(hRandomMaxSlider, showCast);
             ShowWindow(hRandomMaxLabel, showCast);
+            ShowWindow(hCastOptimizerCheck, showCast);
+            ShowWindow(hCastOptimizerLabel, showCast);
         }
         break;
     }
 }
 
+void AutoFishingApp::applyCastOptimizerUI() {
+    bool optimizing = cycle_->settings().castOptimizerEnabled.load();
+    EnableWindow(hCastSlider, !optimizing);
+    EnableWindow(hRandomCastCheck, !optimizing);
+    EnableWindow(hRandomMaxSlider, !optimizing && cycle_->settings().randomCastEnabled.load());
+}
+
 void AutoFishingApp::onHScroll(WPARAM wParam, LPARAM lParam) {
     HWND hSlider = (HWND)lParam;
     int pos = (int)SendMessage(hSlider, TBM_GETPOS, 0, 0);
 
     if (hSlider == hCastSlider) {
         double value = pos * 0.1;
-        castTime.store(value);
+        cycle_->settings().castTime.store(value);
         std::wstringstream ss;
         ss << std::fixed << std::setprecision(1) << value << L"s";
         SetWindowTextW(hCastLabel, ss.str().c_str());
     }
     else if (hSlider == hRestSlider) {
         double value = pos * 0.1;
-        restTime.store(value);
+        cycle_->settings().restTime.store(value);
         std::wstringstream ss;
         ss << std::fixed << std::setprecision(1) << value << L"s";
         SetWindowTextW(hRestLabel, ss.str().c_str());
     }
     else if (hSlider == hTimeoutSlider) {
         double value = pos * 0.1;
-        timeoutLimit.store(value);
+        cycle_->settings().timeoutLimit.store(value);
         std::wstringstream ss;
         ss << std::fixed << std::setprecision(1) << value << L"min";
         SetWindowTextW(hTimeoutLabel, ss.str().c_str());
     }
     else if (hSlider == hRandomMaxSlider) {
         double value = pos * 0.1;
-        randomCastMax.store(value);
+        cycle_->settings().randomCastMax.store(value);
         std::wstringstream ss;
         ss << std::fixed << std::setprecision(1) << value << L"s";
         SetWindowTextW(hRandomMaxLabel, ss.str().c_str());
@@ -530,97 +603,24 @@ void AutoFishingApp::toggle() {
     }
     // std::cout << "--- toggle() called ---" << std::endl;
     // std::cout << "  - running was: " << (running ? "true" : "false") << std::endl;
-    running = !running;
+    bool running = !cycle_->isRunning();
     // std::cout << "  - running is now: " << (running ? "true" : "false") << std::endl;
     SetWindowTextW(hStartButton, running ? getText("stop").c_str() : getText("start").c_str());
 
     if (running) {
-        {
-            std::lock_guard<std::mutex> stateLock(stateMutex_);
-            firstCast = true;
-            castCycleId_ = 0;
-            fishPickupDetected_ = false;
-            pendingBucketCycleId_ = 0;
-            pendingBucketRetry_ = 0;
-            pendingBucketSawAttempt_ = false;
-            pendingBucketStartedAt_ = std::chrono::steady_clock::now();
-            pendingBucketMinEventAt_ = std::chrono::system_clock::time_point{};
-            auto nowSteady = std::chrono::steady_clock::now();
-            auto nowWall = std::chrono::system_clock::now();
-            waitHookStartedAt_ = nowSteady;
-            waitHookStartedWallAt_ = nowWall;
-            currentCycleStartedAt_ = nowSteady;
-            lastHookSavedEventAt_ = nowWall - std::chrono::seconds(60);
-            lastBucketSavedAt_ = nowWall - std::chrono::seconds(60);
-        }
-        updateStatus("Starting");
-        reelTimeoutFlag_ = false;
-        {
-            std::lock_guard<std::mutex> lock(statsMutex);
-            stats.startTime = std::chrono::steady_clock::now();
-        }
-        updateStats();
-
-        if (!fishingThread.joinable()) {
-            fishingThread = std::thread(&AutoFishingApp::fishingLoop, this);
-        }
-        requestCast();
+        cycle_->start();
     }
     else {
-        timeoutId++;
-        reelTimeoutId_++;
-        castRequested_.store(false, std::memory_order_release);
-        {
-            std::lock_guard<std::mutex> stateLock(stateMutex_);
-            pendingBucketCycleId_ = 0;
-            pendingBucketRetry_ = 0;
-            pendingBucketSawAttempt_ = false;
-            pendingBucketStartedAt_ = std::chrono::steady_clock::now();
-            pendingBucketMinEventAt_ = std::chrono::system_clock::time_point{};
-            fishPickupDetected_ = false;
-        }
-        emergencyRelease();
-
-        {
-            std::lock_guard<std::mutex> timerLock(timerThreadMutex_);
-            joinThreadIfNeeded(timeoutThread);
-            joinThreadIfNeeded(reelTimeoutThread_);
-        }
-        {
-            std::lock_guard<std::mutex> lock(statsMutex);
-            stats.reels = 0;
-            stats.timeouts = 0;
-            stats.bucketSuccess = 0;
-        }
-        updateStats();
+        cycle_->stop();
     }
 }
 
 void AutoFishingApp::emergencyRelease() {
-    sendClick(false);
-    updateStatus("Stopped");
-}
-
-bool AutoFishingApp::sleepInterruptible(int totalMs, int stepMs, bool stopOnNotRunning) {
-    int waited = 0;
-    const int chunkMs = (stepMs <= 0) ? 50 : stepMs;
-    while (waited < totalMs) {
-        if (appIsExiting) {
-            return false;
-        }
-        if (stopOnNotRunning && !running) {
-            return false;
-        }
-        int thisChunk = (std::min)(chunkMs, totalMs - waited);
-        std::this_thread::sleep_for(std::chrono::milliseconds(thisChunk));
-        waited += thisChunk;
-    }
-    return !appIsExiting;
+    cycle_->emergencyRelease();
 }
 
 void AutoFishingApp::applyStatusUI() {
-    std::string status = getCurrentAction();
-    std::wstring wStatus = L"[" + getStatusDisplayText(status) + L"]";
+    std::wstring wStatus = L"[" + getStatusDisplayText(getState()) + L"]";
     SetWindowTextW(hStatusLabel, wStatus.c_str());
     updateTrayIcon();
 }
@@ -633,20 +633,16 @@ void AutoFishingApp::applyStatsUI() {
     std::wstring runtimeText = L"0s";
 
     {
-        std::lock_guard<std::mutex> lock(statsMutex);
+        FishingStats stats = cycle_->getStats();
         reels = stats.reels;
         bucket = stats.bucketSuccess;
         timeouts = stats.timeouts;
 
-        if (running) {
-            auto now = std::chrono::steady_clock::now();
+        if (cycle_->isRunning()) {
+            auto now = clock_.now();
             auto duration = std::chrono::duration_cast<std::chrono::seconds>(now - stats.startTime);
             int seconds = (int)duration.count();
-            std::chrono::steady_clock::time_point cycleStartedAt;
-            {
-                std::lock_guard<std::mutex> stateLock(stateMutex_);
-                cycleStartedAt = currentCycleStartedAt_;
-            }
+            std::chrono::steady_clock::time_point cycleStartedAt = cycle_->getCycleStartedAt();
             castSeconds = (int)std::chrono::duration_cast<std::chrono::seconds>(now - cycleStartedAt).count();
             if (castSeconds < 0) castSeconds = 0;
 
@@ -665,6 +661,39 @@ void AutoFishingApp::applyStatsUI() {
     SetWindowTextW(hStatsBucket, std::to_wstring(bucket).c_str());
     SetWindowTextW(hStatsTimeouts, std::to_wstring(timeouts).c_str());
 
+    BiteTimeStats biteTimes = cycle_->getBiteTimeStats();
+    std::wstringstream biteSs;
+    biteSs << L"p" << static_cast<int>(biteTimes.percentile) << L" ";
+    if (biteTimes.estimateSeconds > 0.0) {
+        biteSs << std::fixed << std::setprecision(1) << biteTimes.estimateSeconds << L"s";
+    } else {
+        biteSs << L"--";
+    }
+    biteSs << L" (n=" << biteTimes.bites + biteTimes.censored << L")";
+    SetWindowTextW(hStatsBiteTime, biteSs.str().c_str());
+
+    std::wstringstream limitSs;
+    limitSs << std::fixed << std::setprecision(1) << biteTimes.timeoutSeconds / 60.0 << L"min";
+    SetWindowTextW(hStatsWaitLimit, limitSs.str().c_str());
+
+    std::wstringstream bestCastSs;
+    if (std::optional<CastArmStats> best = cycle_->getBestCastArm()) {
+        bestCastSs << getText("best_cast") << L" " << std::fixed << std::setprecision(1) << best->castTime
+                   << L"s (" << std::setprecision(2) << best->catchesPerMinute() << L"/min)";
+    }
+    SetWindowTextW(hCastOptimizerLabel, bestCastSs.str().c_str());
+
+    LRESULT selectedPhase = SendMessage(hPhaseCombo, CB_GETCURSEL, 0, 0);
+    if (selectedPhase >= 0 && static_cast<size_t>(selectedPhase) < kCyclePhaseCount) {
+        PhaseLatency latency = cycle_->getPhaseLatencies()[static_cast<size_t>(selectedPhase)];
+        std::wstring latencyText = L"--";
+        if (latency.count > 0) {
+            latencyText = L"p50 " + formatPhaseMs(latency.p50Ms) + L"  p95 " + formatPhaseMs(latency.p95Ms)
+                + L"  p99 " + formatPhaseMs(latency.p99Ms);
+        }
+        SetWindowTextW(hPhaseLatency, latencyText.c_str());
+    }
+
     std::wstringstream castSs;
     castSs << getText("cast_runtime") << castSeconds << L"s";
     SetWindowTextW(hStatusCastRuntime, castSs.str().c_str());
@@ -672,11 +701,26 @@ void AutoFishingApp::applyStatsUI() {
     updateTrayIcon();
 }
 
-void AutoFishingApp::updateStatus(const std::string& status) {
-    {
-        std::lock_guard<std::mutex> lock(actionMutex_);
-        currentAction = status;
+void AutoFishingApp::exportPhaseReport() {
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+    localtime_s(&local, &now);
+    char fileName[64];
+    std::strftime(fileName, sizeof(fileName), "phase_timings_%Y%m%d_%H%M%S.csv", &local);
+
+    std::ofstream reportFile(fileName);
+    if (reportFile.is_open()) {
+        cycle_->writePhaseReport(reportFile);
     }
+    if (!reportFile.is_open() || !reportFile) {
+        MessageBoxW(hwnd, getText("export_failed").c_str(), L"Export Error", MB_OK | MB_ICONERROR);
+        return;
+    }
+    std::wstring wFileName = stringToWString(fileName);
+    MessageBoxW(hwnd, wFileName.c_str(), getText("export").c_str(), MB_OK | MB_ICONINFORMATION);
+}
+
+void AutoFishingApp::updateStatus() {
     if (GetCurrentThreadId() != uiThreadId_) {
         PostMessage(hwnd, WM_APP_UPDATE_STATUS, 0, 0);
         return;
@@ -685,21 +729,18 @@ void AutoFishingApp::updateStatus(const std::string& status) {
 }
 
 void AutoFishingApp::updateTrayIcon() {
-    std::string status = getCurrentAction();
-    HICON newIcon = statusIcons.count(status) ? statusIcons[status] : statusIcons["Stopped"];
+    FishingState state = getState();
+    HICON newIcon = statusIcons[static_cast<size_t>(state)];
     if (newIcon) {
         nid.hIcon = newIcon;
         
         // Update tooltip with current status and statistics
-        std::wstring statusText = getStatusDisplayText(status);
+        std::wstring statusText = getStatusDisplayText(state);
         std::wstringstream tooltip;
         
-        int reels, bucket;
-        {
-            std::lock_guard<std::mutex> lock(statsMutex);
-            reels = stats.reels;
-            bucket = stats.bucketSuccess;
-        }
+        FishingStats stats = cycle_->getStats();
+        int reels = stats.reels;
+        int bucket = stats.bucketSuccess;
         
         tooltip << getText("tray_tooltip") << L" - " << statusText;
         if (currentLanguage == Language::Chinese) {
@@ -725,578 +766,21 @@ void AutoFishingApp::updateStats() {
 
 void AutoFishingApp::updateStatsLoop() {
     while (!appIsExiting) {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-        if (running && !appIsExiting) {
+        cycle_->waitFor(std::chrono::seconds(1));
+        if (cycle_->isRunning() && !appIsExiting) {
             updateStats();
         }
     }
 }
 
-void AutoFishingApp::sendClick(bool press) {
-    if (oscClient) {
-        oscClient->sendClick(press);
-    }
-}
-
-double AutoFishingApp::getCastDuration() {
-    if (randomCastEnabled.load()) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<> dis(FishingConfig::MIN_CAST_TIME, randomCastMax.load());
-        return dis(gen);
-    }
-    return castTime.load();
-}
-
-void AutoFishingApp::requestCast() {
-    if (!running || appIsExiting) {
-        return;
-    }
-    castRequested_.store(true, std::memory_order_release);
-}
-
-void AutoFishingApp::fishingLoop() {
-    while (!appIsExiting) {
-        if (!running) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
-            continue;
-        }
-        if (!castRequested_.exchange(false, std::memory_order_acq_rel)) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(20));
-            continue;
-        }
-        WorkerGuard guard(activeWorkers_);
-        performCast();
-    }
-}
-
-void AutoFishingApp::performCast() {
-    if (!running) return;
-
-    if (maybeRecoverMissingBucket()) {
-        return;
-    }
-
-    {
-        std::lock_guard<std::mutex> stateLock(stateMutex_);
-        if (firstCast) {
-            firstCast = false;
-        }
-        castCycleId_++;
-        currentCycleStartedAt_ = std::chrono::steady_clock::now();
-    }
-
-    if (noCastMode.load()) {
-        {
-            std::lock_guard<std::mutex> stateLock(stateMutex_);
-            waitHookStartedAt_ = std::chrono::steady_clock::now();
-            waitHookStartedWallAt_ = std::chrono::system_clock::now();
-        }
-        updateStatus("WaitingFish");
-        startTimeoutTimer();
-        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(FishingConfig::CAST_WAIT_TIME * 1000)));
-        return;
-    }
-
-    // Normal casting mode
-    updateStatus("Casting");
-    double duration = getCastDuration();
-    updateStats();
-
-    sendClick(true);
-    std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(duration * 1000)));
-    sendClick(false);
-
-    if (!running) return;
-
-    {
-        std::lock_guard<std::mutex> stateLock(stateMutex_);
-        lastCastTime_ = std::chrono::steady_clock::now();
-        waitHookStartedAt_ = std::chrono::steady_clock::now();
-        waitHookStartedWallAt_ = std::chrono::system_clock::now();
-    }
-    updateStatus("WaitingFish");
-    startTimeoutTimer();
-    std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(FishingConfig::CAST_WAIT_TIME * 1000)));
-}
-
-bool AutoFishingApp::performReel(bool isTimeout) {
-    updateStatus("Reeling");
-    {
-        std::lock_guard<std::mutex> lock(statsMutex);
-        stats.reels++;
-    }
-    updateStats();
-
-    reelTimeoutFlag_ = false;
-    startReelTimeoutTimer();
-
-    sendClick(true);
-
-    bool confirmed = false;
-
-    if (isTimeout) {
-        auto reelStart = std::chrono::steady_clock::now();
-        while (running && !reelTimeoutFlag_) {
-            auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-                std::chrono::steady_clock::now() - reelStart).count();
-            if (elapsed >= FishingConfig::TIMEOUT_REEL_WAIT) {
-                break;
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-    } else {
-        bool success = checkFishPickup();
-        if (success && !reelTimeoutFlag_) {
-            auto now = std::chrono::steady_clock::now();
-            std::chrono::steady_clock::time_point localDetected;
-            {
-                std::lock_guard<std::mutex> stateLock(stateMutex_);
-                localDetected = detectedTime;
-            }
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - localDetected).count() / 1000.0;
-            double remaining = (std::max)(0.0, FishingConfig::FISH_PICKUP_WAIT_TIME - elapsed);
-            if (remaining > 0) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(remaining * 1000)));
-            }
-            confirmed = true;
-        }
-    }
-
-    reelTimeoutId_++;
-    fishPickupDetected_ = false;
-    sendClick(false);
-    return confirmed;
-}
-
-void AutoFishingApp::startReelTimeoutTimer() {
-    int currentReelTimeoutId = ++reelTimeoutId_;
-
-    std::lock_guard<std::mutex> timerLock(timerThreadMutex_);
-    joinThreadIfNeeded(reelTimeoutThread_);
-    reelTimeoutThread_ = std::thread([this, currentReelTimeoutId]() {
-        WorkerGuard guard(activeWorkers_);
-        int timeoutMs = static_cast<int>(FishingConfig::MAX_REEL_TIME * 1000);
-        int waited = 0;
-        while (waited < timeoutMs) {
-            if (!sleepInterruptible(100, 100, true)) {
-                return;
-            }
-            waited += 100;
-            if (reelTimeoutId_.load() != currentReelTimeoutId) {
-                return;
-            }
-        }
-        
-        if (!appIsExiting && reelTimeoutId_.load() == currentReelTimeoutId && running) {
-            handleReelTimeout();
-        }
-    });
-}
-
-void AutoFishingApp::handleReelTimeout() {
-    reelTimeoutFlag_ = true;
-}
-
-bool AutoFishingApp::checkFishPickup() {
-    auto startTime = std::chrono::steady_clock::now();
-    std::chrono::system_clock::time_point waitStartedWall;
-    {
-        std::lock_guard<std::mutex> stateLock(stateMutex_);
-        waitStartedWall = waitHookStartedWallAt_;
-    }
-    auto waitStartWithTolerance = waitStartedWall - std::chrono::milliseconds(200);
-
-    while (running && !reelTimeoutFlag_) {
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - startTime).count();
-        
-        if (elapsed >= FishingConfig::FISH_PICKUP_TIMEOUT) {
-            break;
-        }
-
-        if (fishPickupDetected_) {
-            std::lock_guard<std::mutex> stateLock(stateMutex_);
-            detectedTime = fishPickupDetectedAt_;
-            return true;
-        }
-
-        // Fallback detection: tail snapshot only (do not consume shared incremental cursor).
-        std::string contentTail = logHandler ? logHandler->readTail() : "";
-        std::string merged;
-        if (!contentTail.empty()) {
-            merged += contentTail;
-        }
-
-        if (!merged.empty()) {
-            std::istringstream stream(merged);
-            std::string line;
-            while (std::getline(stream, line)) {
-                if (!line.empty() && line.back() == '\r') {
-                    line.pop_back();
-                }
-                if (line.find(VRChatLogHandler::FISH_PICKUP_KEYWORD) == std::string::npos) {
-                    continue;
-                }
-                auto eventTime = extractLogTimestamp(line);
-                if (eventTime && *eventTime >= waitStartWithTolerance) {
-                    std::lock_guard<std::mutex> stateLock(stateMutex_);
-                    detectedTime = std::chrono::steady_clock::now();
-                    fishPickupDetected_ = true;
-                    fishPickupDetectedAt_ = detectedTime;
-                    return true;
-                }
-            }
-        }
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
-    }
-
-    return false;
-}
-
-void AutoFishingApp::startTimeoutTimer() {
-    int currentTimeoutId = ++timeoutId;
-
-    std::lock_guard<std::mutex> timerLock(timerThreadMutex_);
-    joinThreadIfNeeded(timeoutThread);
-    timeoutThread = std::thread([this, currentTimeoutId]() {
-        WorkerGuard guard(activeWorkers_);
-        int timeoutMs = static_cast<int>(timeoutLimit.load() * 60 * 1000);
-        int waited = 0;
-        while (waited < timeoutMs) {
-            if (!sleepInterruptible(100, 100, true)) {
-                return;
-            }
-            waited += 100;
-            if (timeoutId.load() != currentTimeoutId) {
-                return;
-            }
-        }
-        
-        if (!appIsExiting && timeoutId.load() == currentTimeoutId && running && getCurrentAction() == "WaitingFish") {
-            handleTimeout();
-        }
-    });
-}
-
-void AutoFishingApp::handleTimeout() {
-    if (running && getCurrentAction() == "WaitingFish") {
-        updateStatus("Timeout");
-        {
-            std::lock_guard<std::mutex> lock(statsMutex);
-            stats.timeouts++;
-        }
-        updateStats();
-        forceReel();
-    }
-}
-
-void AutoFishingApp::forceReel() {
-    if (!running) return;
-
-    ProtectedGuard guard(protected_);
-    if (!guard.acquired()) {
-        return;
-    }
-    (void)performReel(true);
-
-    if (!running) return;
-
-    updateStatus("Resting");
-    std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(FishingConfig::FORCE_REEL_REST * 1000)));
-
-    if (running) {
-        requestCast();
-    }
-}
-
-void AutoFishingApp::onLogEvent(LogEventType eventType, const std::string& line) {
-    if (appIsExiting) {
-        return;
-    }
-    switch (eventType) {
-        case LogEventType::FishOnHook:
-            fishOnHook(line);
-            break;
-        case LogEventType::FishPickup:
-            fishPickup(line);
-            break;
-        case LogEventType::BucketSave:
-            bucketSave();
-            break;
-    }
-}
-
-std::optional<std::chrono::system_clock::time_point> AutoFishingApp::extractLogTimestamp(const std::string& line) const {
-    static const std::regex kLineTimePattern(R"((\d{4})\.(\d{2})\.(\d{2}) (\d{2}):(\d{2}):(\d{2}))");
-    std::smatch match;
-    if (!std::regex_search(line, match, kLineTimePattern) || match.size() < 7) {
-        return std::nullopt;
-    }
-
-    std::tm tmValue{};
-    tmValue.tm_year = std::stoi(match[1].str()) - 1900;
-    tmValue.tm_mon = std::stoi(match[2].str()) - 1;
-    tmValue.tm_mday = std::stoi(match[3].str());
-    tmValue.tm_hour = std::stoi(match[4].str());
-    tmValue.tm_min = std::stoi(match[5].str());
-    tmValue.tm_sec = std::stoi(match[6].str());
-    tmValue.tm_isdst = -1;
-
-    std::time_t localTime = std::mktime(&tmValue);
-    if (localTime == static_cast<std::time_t>(-1)) {
-        return std::nullopt;
-    }
-    return std::chrono::system_clock::from_time_t(localTime);
-}
-
-bool AutoFishingApp::tryConsumeDeferredBucket(const std::string& line) {
-    if (!running || line.empty()) {
-        return false;
-    }
-
-    if (line.find(VRChatLogHandler::FISH_HOOK_KEYWORD) == std::string::npos) {
-        return false;
-    }
-
-    auto eventTime = extractLogTimestamp(line);
-    {
-        std::lock_guard<std::mutex> stateLock(stateMutex_);
-        if (pendingBucketCycleId_ <= 0 || !pendingBucketSawAttempt_ || !eventTime || *eventTime < pendingBucketMinEventAt_) {
-            return false;
-        }
-    }
-
-    {
-        std::lock_guard<std::mutex> lock(statsMutex);
-        stats.bucketSuccess++;
-    }
-    updateStats();
-
-    {
-        std::lock_guard<std::mutex> stateLock(stateMutex_);
-        lastBucketSavedAt_ = *eventTime;
-        pendingBucketCycleId_ = 0;
-        pendingBucketRetry_ = 0;
-        pendingBucketSawAttempt_ = false;
-        pendingBucketStartedAt_ = std::chrono::steady_clock::now();
-        pendingBucketMinEventAt_ = std::chrono::system_clock::time_point{};
-    }
-    return true;
-}
-
-void AutoFishingApp::startDeferredBucketTracking(int cycleId, const std::optional<std::chrono::system_clock::time_point>& minEventAt) {
-    std::lock_guard<std::mutex> stateLock(stateMutex_);
-    pendingBucketCycleId_ = cycleId;
-    pendingBucketRetry_ = 0;
-    pendingBucketSawAttempt_ = false;
-    pendingBucketStartedAt_ = std::chrono::steady_clock::now();
-    pendingBucketMinEventAt_ = minEventAt.value_or(std::chrono::system_clock::time_point{});
-}
-
-void AutoFishingApp::clearDeferredBucketTracking() {
-    std::lock_guard<std::mutex> stateLock(stateMutex_);
-    pendingBucketCycleId_ = 0;
-    pendingBucketRetry_ = 0;
-    pendingBucketSawAttempt_ = false;
-    pendingBucketStartedAt_ = std::chrono::steady_clock::now();
-    pendingBucketMinEventAt_ = std::chrono::system_clock::time_point{};
-}
-
-bool AutoFishingApp::maybeRecoverMissingBucket() {
-    if (!running) {
-        return false;
-    }
-
-    double elapsed = 0.0;
-    int pendingCycleId = 0;
-    {
-        std::lock_guard<std::mutex> stateLock(stateMutex_);
-        if (pendingBucketCycleId_ <= 0) {
-            return false;
-        }
-        pendingCycleId = pendingBucketCycleId_;
-        auto now = std::chrono::steady_clock::now();
-        elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - pendingBucketStartedAt_).count() / 1000.0;
-    }
-    if (elapsed < FishingConfig::BUCKET_SAVE_TIMEOUT_SECONDS) {
-        return false;
-    }
-
-    // If bucket is not confirmed within timeout window, force timeout refish.
-    {
-        std::lock_guard<std::mutex> stateLock(stateMutex_);
-        pendingBucketCycleId_ = 0;
-        pendingBucketRetry_ = 0;
-        pendingBucketSawAttempt_ = false;
-        pendingBucketStartedAt_ = std::chrono::steady_clock::now();
-        pendingBucketMinEventAt_ = std::chrono::system_clock::time_point{};
-    }
-    std::cerr << "[BucketRecovery] cycle=" << pendingCycleId
-              << " no-bucket-within-5s => timeout-refish" << std::endl;
-    {
-        std::lock_guard<std::mutex> lock(statsMutex);
-        stats.timeouts++;
-    }
-    updateStats();
-    updateStatus("Timeout");
-
-    ProtectedGuard guard(protected_);
-    if (!guard.acquired()) {
-        requestCast();
-        return true;
-    }
-
-    (void)performReel(true);
-    if (!running) {
-        return true;
-    }
-    updateStatus("Resting");
-    std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(FishingConfig::FORCE_REEL_REST * 1000)));
-    if (running) {
-        requestCast();
-    }
-    return true;
-}
-
-void AutoFishingApp::fishOnHook(const std::string& line) {
-    if (tryConsumeDeferredBucket(line)) {
-        return;
-    }
-
-    auto eventTime = extractLogTimestamp(line);
-    if (!eventTime) {
-        return;
-    }
-
-    auto nowSteady = std::chrono::steady_clock::now();
-
-    std::chrono::steady_clock::time_point lastCycleEnd;
-    std::chrono::steady_clock::time_point waitHookStartedAt;
-    std::chrono::system_clock::time_point waitHookStartedWallAt;
-    std::chrono::system_clock::time_point lastBucketSavedAt;
-    std::chrono::system_clock::time_point lastHookSavedEventAt;
-    int castCycleId = 0;
-    {
-        std::lock_guard<std::mutex> stateLock(stateMutex_);
-        lastCycleEnd = this->lastCycleEnd;
-        waitHookStartedAt = waitHookStartedAt_;
-        waitHookStartedWallAt = waitHookStartedWallAt_;
-        lastBucketSavedAt = lastBucketSavedAt_;
-        lastHookSavedEventAt = lastHookSavedEventAt_;
-        castCycleId = castCycleId_;
-    }
-
-    auto elapsedSinceCycle = std::chrono::duration_cast<std::chrono::seconds>(
-        nowSteady - lastCycleEnd).count();
-
-    if (!running || getCurrentAction() != "WaitingFish" || elapsedSinceCycle < FishingConfig::CYCLE_COOLDOWN) {
-        return;
-    }
-
-    auto sinceWait = std::chrono::duration_cast<std::chrono::milliseconds>(nowSteady - waitHookStartedAt).count() / 1000.0;
-    if (sinceWait < FishingConfig::HOOK_MIN_WAIT_SECONDS) {
-        return;
-    }
-
-    if (std::chrono::duration_cast<std::chrono::milliseconds>(*eventTime - lastBucketSavedAt).count() / 1000.0
-        <= FishingConfig::BUCKET_EVENT_COOLDOWN_SECONDS) {
-        return;
-    }
-
-    if (std::chrono::duration_cast<std::chrono::milliseconds>(*eventTime - lastHookSavedEventAt).count() / 1000.0
-        <= FishingConfig::SAVED_DATA_CLUSTER_SECONDS) {
-        return;
-    }
-
-    auto waitStartWithTolerance = waitHookStartedWallAt - std::chrono::milliseconds(200);
-    if (*eventTime < waitStartWithTolerance) {
-        return;
-    }
-
-    ProtectedGuard guard(protected_);
-    if (!guard.acquired()) {
-        return;
-    }
-    timeoutId++;
-    {
-        std::lock_guard<std::mutex> stateLock(stateMutex_);
-        this->lastCycleEnd = std::chrono::steady_clock::now();
-        lastHookSavedEventAt_ = *eventTime;
-        fishPickupDetected_ = false;
-    }
-    bool reelConfirmed = performReel(false);
-
-    if (!running) return;
-
-    if (!reelConfirmed) {
-        updateStatus("Resting");
-        std::this_thread::sleep_for(std::chrono::milliseconds(300));
-        if (running) {
-            requestCast();
-        }
-        {
-            std::lock_guard<std::mutex> stateLock(stateMutex_);
-            this->lastCycleEnd = std::chrono::steady_clock::now();
-        }
-        return;
-    }
-
-    startDeferredBucketTracking(castCycleId, eventTime);
-    updateStatus("Resting");
-    std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(restTime.load() * 1000)));
-
-    if (running) {
-        requestCast();
-    }
-
-    {
-        std::lock_guard<std::mutex> stateLock(stateMutex_);
-        this->lastCycleEnd = std::chrono::steady_clock::now();
-    }
-}
-
-void AutoFishingApp::fishPickup(const std::string& line) {
-    if (!running || getCurrentAction() != "Reeling") {
-        return;
-    }
-
-    auto eventTime = extractLogTimestamp(line);
-    if (eventTime) {
-        std::chrono::system_clock::time_point waitStartedWall;
-        {
-            std::lock_guard<std::mutex> stateLock(stateMutex_);
-            waitStartedWall = waitHookStartedWallAt_;
-        }
-        auto waitStartWithTolerance = waitStartedWall - std::chrono::milliseconds(200);
-        if (*eventTime < waitStartWithTolerance) {
-            return;
-        }
-    }
-
-    {
-        std::lock_guard<std::mutex> stateLock(stateMutex_);
-        fishPickupDetectedAt_ = std::chrono::steady_clock::now();
-        fishPickupDetected_ = true;
-    }
-}
-
-void AutoFishingApp::bucketSave() {
-    std::lock_guard<std::mutex> stateLock(stateMutex_);
-    if (pendingBucketCycleId_ > 0) {
-        pendingBucketSawAttempt_ = true;
-    }
-}
-
 void AutoFishingApp::startFishing() {
-    if (!running) {
+    if (!cycle_->isRunning()) {
         toggle();
     }
 }
 
 void AutoFishingApp::stopFishing() {
-    if (running) {
+    if (cycle_->isRunning()) {
         toggle();
     }
 }
@@ -1309,11 +793,10 @@ void AutoFishingApp::restartFishing() {
 
     joinThreadIfNeeded(restartThread_);
     restartThread_ = std::thread([this]() {
-        WorkerGuard guard(activeWorkers_);
-
-        if (running) {
+        if (cycle_->isRunning()) {
             stopFishing();
-            if (!sleepInterruptible(static_cast<int>(FishingConfig::RESTART_WAIT_TIME * 1000), 100)) {
+            auto restartWait = std::chrono::milliseconds(static_cast<int>(FishingConfig::RESTART_WAIT_TIME * 1000));
+            if (cycle_->waitFor(restartWait) == FishingCycle::WaitResult::Cancelled) {
                 restartInProgress_.store(false);
                 return;
             }
@@ -1359,6 +842,33 @@ void AutoFishingApp::unregisterHotkeys() {
     UnregisterHotKey(hwnd, ID_HOTKEY_RESTART);
 }
 
+void AutoFishingApp::loadOscTargets() {
+    oscTargets_ = { OscTarget{ "127.0.0.1", 9000 } };
+    std::ifstream configFile("config.json");
+    if (!configFile.is_open()) {
+        return;
+    }
+
+    try {
+        json config;
+        configFile >> config;
+        if (!config.contains("oscTargets") || !config["oscTargets"].is_array()) {
+            return;
+        }
+        std::vector<OscTarget> targets;
+        for (const json& entry : config["oscTargets"]) {
+            if (entry.is_object()) {
+                targets.push_back({ entry.value("host", std::string("127.0.0.1")), entry.value("port", 9000) });
+            }
+        }
+        if (!targets.empty()) {
+            oscTargets_ = targets;
+        }
+    } catch (const json::exception& e) {
+        (void)e; // loadConfig() reports a broken file
+    }
+}
+
 void AutoFishingApp::loadConfig() {
     std::ifstream configFile("config.json");
     if (!configFile.is_open()) {
@@ -1371,26 +881,72 @@ void AutoFishingApp::loadConfig() {
         json config;
         configFile >> config;
 
-        castTime.store(config.value("castTime", FishingConfig::DEFAULT_CAST_TIME));
-        restTime.store(config.value("restTime", FishingConfig::DEFAULT_REST_TIME));
-        timeoutLimit.store(config.value("timeoutLimit", FishingConfig::DEFAULT_TIMEOUT_MINUTES));
-        randomCastEnabled.store(config.value("randomCastEnabled", false));
-        randomCastMax.store(config.value("randomCastMax", 1.0));
-        noCastMode.store(config.value("noCastMode", false));
+        cycle_->settings().castTime.store(config.value("castTime", FishingConfig::DEFAULT_CAST_TIME));
+        cycle_->settings().restTime.store(config.value("restTime", FishingConfig::DEFAULT_REST_TIME));
+        cycle_->settings().timeoutLimit.store(config.value("timeoutLimit", FishingConfig::DEFAULT_TIMEOUT_MINUTES));
+        cycle_->settings().randomCastEnabled.store(config.value("randomCastEnabled", false));
+        cycle_->settings().randomCastMax.store(config.value("randomCastMax", 1.0));
+        cycle_->settings().castOptimizerEnabled.store(config.value("castOptimizerEnabled", false));
+        cycle_->settings().noCastMode.store(config.value("noCastMode", false));
+        cycle_->settings().adaptiveTimeout.store(config.value("adaptiveTimeout", false));
+        cycle_->settings().adaptiveTimeoutPercentile.store(std::clamp(
+            config.value("adaptiveTimeoutPercentile", FishingConfig::DEFAULT_ADAPTIVE_TIMEOUT_PERCENTILE),
+            FishingConfig::MIN_ADAPTIVE_TIMEOUT_PERCENTILE, FishingConfig::MAX_ADAPTIVE_TIMEOUT_PERCENTILE));
+        std::string castTiming = config.value("castTiming", std::string(kCastTimingNames[0]));
+        for (size_t timing = 0; timing < kCastTimingCount; ++timing) {
+            if (castTiming == kCastTimingNames[timing]) {
+                cycle_->settings().castTiming.store(static_cast<CastTiming>(timing));
+            }
+        }
+
+        oscListenPort_ = config.value("oscListenPort", FishingConfig::DEFAULT_OSC_LISTEN_PORT);
+        oscBindings_.clear();
+        if (config.contains("oscBindings") && config["oscBindings"].is_array()) {
+            for (const json& entry : config["oscBindings"]) {
+                if (!entry.is_object()) {
+                    continue;
+                }
+                std::string event = entry.value("event", std::string());
+                for (size_t type = 0; type < kLogEventTypeCount; ++type) {
+                    if (event == kLogEventTypeNames[type]) {
+                        oscBindings_.push_back({ entry.value("address", std::string()), kLogEventTypes[type] });
+                    }
+                }
+            }
+        }
 
         // Update UI elements
-        SendMessage(hCastSlider, TBM_SETPOS, TRUE, static_cast<int>(castTime.load() * 10));
-        SendMessage(hRestSlider, TBM_SETPOS, TRUE, static_cast<int>(restTime.load() * 10));
-        SendMessage(hTimeoutSlider, TBM_SETPOS, TRUE, static_cast<int>(timeoutLimit.load() * 10));
-        SendMessage(hRandomMaxSlider, TBM_SETPOS, TRUE, static_cast<int>(randomCastMax.load() * 10));
+        SendMessage(hCastSlider, TBM_SETPOS, TRUE, static_cast<int>(cycle_->settings().castTime.load() * 10));
+        SendMessage(hRestSlider, TBM_SETPOS, TRUE, static_cast<int>(cycle_->settings().restTime.load() * 10));
+        SendMessage(hTimeoutSlider, TBM_SETPOS, TRUE, static_cast<int>(cycle_->settings().timeoutLimit.load() * 10));
+        SendMessage(hRandomMaxSlider, TBM_SETPOS, TRUE, static_cast<int>(cycle_->settings().randomCastMax.load() * 10));
         
-        SendMessage(hRandomCastCheck, BM_SETCHECK, randomCastEnabled.load() ? BST_CHECKED : BST_UNCHECKED, 0);
-        SendMessage(hNoCastCheckbox, BM_SETCHECK, noCastMode.load() ? BST_CHECKED : BST_UNCHECKED, 0);
+        SendMessage(hRandomCastCheck, BM_SETCHECK, cycle_->settings().randomCastEnabled.load() ? BST_CHECKED : BST_UNCHECKED, 0);
+        SendMessage(hNoCastCheckbox, BM_SETCHECK, cycle_->settings().noCastMode.load() ? BST_CHECKED : BST_UNCHECKED, 0);
+        SendMessage(hAdaptiveTimeoutCheck, BM_SETCHECK, cycle_->settings().adaptiveTimeout.load() ? BST_CHECKED : BST_UNCHECKED, 0);
         
-        EnableWindow(hRandomMaxSlider, randomCastEnabled.load());
+        SendMessage(hCastOptimizerCheck, BM_SETCHECK, cycle_->settings().castOptimizerEnabled.load() ? BST_CHECKED : BST_UNCHECKED, 0);
+        applyCastOptimizerUI();
+
+        // What the optimizer learned in earlier sessions
+        if (config.contains("castOptimizerArms") && config["castOptimizerArms"].is_array()) {
+            std::vector<CastArmStats> arms;
+            for (const json& entry : config["castOptimizerArms"]) {
+                if (!entry.is_object()) {
+                    continue;
+                }
+                CastArmStats arm;
+                arm.castTime = entry.value("castTime", 0.0);
+                arm.catches = entry.value("catches", 0.0);
+                arm.minutes = entry.value("minutes", 0.0);
+                arm.pulls = entry.value("pulls", uint64_t{ 0 });
+                arms.push_back(arm);
+            }
+            cycle_->restoreCastArms(arms);
+        }
         
         // Update visibility based on noCastMode
-        int showCast = noCastMode.load() ? SW_HIDE : SW_SHOW;
+        int showCast = cycle_->settings().noCastMode.load() ? SW_HIDE : SW_SHOW;
         ShowWindow(hCastTimeLabel, showCast);
         ShowWindow(hCastSlider, showCast);
         ShowWindow(hCastLabel, showCast);
@@ -1398,6 +954,8 @@ void AutoFishingApp::loadConfig() {
         ShowWindow(hRandomMaxTitleLabel, showCast);
         ShowWindow(hRandomMaxSlider, showCast);
         ShowWindow(hRandomMaxLabel, showCast);
+        ShowWindow(hCastOptimizerCheck, showCast);
+        ShowWindow(hCastOptimizerLabel, showCast);
         
         // Manually trigger update for labels
         onHScroll(0, (LPARAM)hCastSlider);
@@ -1405,20 +963,48 @@ void AutoFishingApp::loadConfig() {
         onHScroll(0, (LPARAM)hTimeoutSlider);
         onHScroll(0, (LPARAM)hRandomMaxSlider);
 
-    } catch (const json::parse_error& e) {
+    } catch (const json::exception& e) {
+        // A parse error, or an entry of the wrong type such as "castTime": "0.5"
         (void)e; // Mark as unused to prevent warning
-        MessageBoxW(hwnd, L"Failed to parse config.json. Using default settings.", L"Config Error", MB_OK | MB_ICONWARNING);
+        MessageBoxW(hwnd, L"Failed to read config.json. Settings it did not set keep their defaults.", L"Config Error", MB_OK | MB_ICONWARNING);
     }
 }
 
 void AutoFishingApp::saveConfig() {
     json config;
-    config["castTime"] = castTime.load();
-    config["restTime"] = restTime.load();
-    config["timeoutLimit"] = timeoutLimit.load();
-    config["randomCastEnabled"] = randomCastEnabled.load();
-    config["randomCastMax"] = randomCastMax.load();
-    config["noCastMode"] = noCastMode.load();
+    config["castTime"] = cycle_->settings().castTime.load();
+    config["restTime"] = cycle_->settings().restTime.load();
+    config["timeoutLimit"] = cycle_->settings().timeoutLimit.load();
+    config["randomCastEnabled"] = cycle_->settings().randomCastEnabled.load();
+    config["randomCastMax"] = cycle_->settings().randomCastMax.load();
+    config["noCastMode"] = cycle_->settings().noCastMode.load();
+    config["adaptiveTimeout"] = cycle_->settings().adaptiveTimeout.load();
+    config["adaptiveTimeoutPercentile"] = cycle_->settings().adaptiveTimeoutPercentile.load();
+    config["castOptimizerEnabled"] = cycle_->settings().castOptimizerEnabled.load();
+    config["castTiming"] = kCastTimingNames[static_cast<size_t>(cycle_->settings().castTiming.load())];
+
+    json arms = json::array();
+    for (const CastArmStats& arm : cycle_->getCastArms()) {
+        if (arm.pulls > 0) {
+            arms.push_back({ {"castTime", arm.castTime}, {"catches", arm.catches},
+                             {"minutes", arm.minutes}, {"pulls", arm.pulls} });
+        }
+    }
+    config["castOptimizerArms"] = arms;
+
+    json targets = json::array();
+    for (const OscTarget& target : oscTargets_) {
+        targets.push_back({ {"host", target.host}, {"port", target.port} });
+    }
+    config["oscTargets"] = targets;
+
+    config["oscListenPort"] = oscListenPort_;
+    json bindings = json::array();
+    for (const OscBinding& binding : oscBindings_) {
+        bindings.push_back({ {"address", binding.address},
+                             {"event", kLogEventTypeNames[static_cast<size_t>(binding.type)]} });
+    }
+    config["oscBindings"] = bindings;
 
     std::ofstream configFile("config.json");
     if (configFile.is_open()) {
@@ -1428,13 +1014,34 @@ void AutoFishingApp::saveConfig() {
     }
 }
 
+void AutoFishingApp::startOscServer() {
+    if (oscBindings_.empty()) {
+        return;
+    }
+
+    oscServer_ = new OSCServer(clock_, [this](const LogEvent& event) {
+        if (!appIsExiting) {
+            cycle_->onLogEvent(event);
+        }
+    }, "127.0.0.1", oscListenPort_);
+    for (const OscBinding& binding : oscBindings_) {
+        if (!oscServer_->addBinding(binding.address, binding.type)) {
+            std::cerr << "Invalid OSC binding \"" << binding.address << "\" for "
+                      << kLogEventTypeNames[static_cast<size_t>(binding.type)] << std::endl;
+        }
+    }
+    if (!oscServer_->start()) {
+        MessageBoxW(hwnd, L"Failed to listen for OSC. Is another program using the port?", L"OSC Error", MB_OK | MB_ICONWARNING);
+    }
+}
+
 void AutoFishingApp::setupTrayIcon() {
     nid.cbSize = sizeof(NOTIFYICONDATA);
     nid.hWnd = hwnd;
     nid.uID = 1;
     nid.uFlags = NIF_ICON | NIF_MESSAGE | NIF_TIP;
     nid.uCallbackMessage = WM_TRAYICON;
-    nid.hIcon = statusIcons["Waiting"];
+    nid.hIcon = statusIcons[static_cast<size_t>(FishingState::Waiting)];
     wcscpy_s(nid.szTip, getText("tray_tooltip").c_str());
     Shell_NotifyIcon(NIM_ADD, &nid);
 }
@@ -1,6 +1,9 @@
 #pragma once
+#include "FishingClock.h"
 #include "FishingConfig.h"
+#include "FishingCycle.h"
 #include "OSCClient.h"
+#include "OSCServer.h"
 #include "VRChatLogHandler.h"
 #include <windows.h>
 #include <commctrl.h>
@@ -11,7 +14,9 @@
 #include <thread>
 #include <chrono>
 #include <map>
+#include <array>
 #include <optional>
+#include <vector>
 #include "nlohmann/json.hpp"
 
 // Language enum
@@ -40,6 +45,14 @@ enum class Language {
 #define IDC_STATS_RUNTIME       1016
 #define IDC_NO_CAST_CHECKBOX    1017
 #define IDC_STATUS_CAST_RUNTIME 1018
+#define IDC_ADAPTIVE_TIMEOUT_CHECK 1019
+#define IDC_STATS_BITE_TIME     1020
+#define IDC_STATS_WAIT_LIMIT    1021
+#define IDC_CAST_OPTIMIZER_CHECK 1022
+#define IDC_CAST_OPTIMIZER_LABEL 1023
+#define IDC_PHASE_COMBO         1024
+#define IDC_PHASE_LATENCY       1025
+#define IDC_PHASE_EXPORT        1026
 
 // Hotkey IDs
 #define ID_HOTKEY_TOGGLE_WINDOW 2000
@@ -56,7 +69,7 @@ class AutoFishingApp {
 private:
     Language currentLanguage;
     NOTIFYICONDATA nid;
-    std::map<std::string, HICON> statusIcons;
+    std::array<HICON, kFishingStateCount> statusIcons{};
     HWND hwnd;
     HWND hStartButton;
     HWND hCastTimeLabel;
@@ -68,6 +81,7 @@ private:
     HWND hTimeoutTimeLabel_title;
     HWND hTimeoutSlider;
     HWND hTimeoutLabel;
+    HWND hAdaptiveTimeoutCheck;
     HWND hStatusLabel;
     HWND hStatusCastRuntime;
     HWND hRandomCastCheck;
@@ -75,107 +89,63 @@ private:
     HWND hRandomMaxSlider;
     HWND hRandomMaxLabel;
     HWND hNoCastCheckbox;
+    HWND hCastOptimizerCheck;
+    HWND hCastOptimizerLabel;
     HWND hStatsReels;
     HWND hStatsBucket;
     HWND hStatsTimeouts;
     HWND hStatsRuntime;
+    HWND hStatsBiteTime;
+    HWND hStatsWaitLimit;
+    HWND hPhaseCombo;
+    HWND hPhaseLatency;
+    HWND hPhaseExportButton;
     
     HFONT hFont;
 
+    SystemClock clock_;
     OSCClient* oscClient;
+    // VRChat clients every click goes to
+    std::vector<OscTarget> oscTargets_;
     VRChatLogHandler* logHandler;
+    FishingCycle* cycle_;
+    // Only created when config.json binds OSC addresses to events
+    OSCServer* oscServer_;
+    int oscListenPort_;
+    std::vector<OscBinding> oscBindings_;
 
-    std::atomic<bool> running;
-    std::atomic<bool> protected_;
     std::atomic<bool> appIsExiting;
-    std::atomic<bool> reelTimeoutFlag_;
-    std::string currentAction;
-    std::chrono::steady_clock::time_point lastCycleEnd;
-    std::chrono::steady_clock::time_point lastCastTime_;
-    std::thread fishingThread;
-    std::thread timeoutThread;
-    std::thread reelTimeoutThread_;
     std::thread restartThread_;
     std::thread statsThread;
-    std::mutex statsMutex;
-    mutable std::mutex actionMutex_;
-    mutable std::mutex stateMutex_;
-    std::mutex timerThreadMutex_;
     std::mutex lifecycleMutex_;
-    std::atomic<int> timeoutId;
-    std::atomic<int> reelTimeoutId_;
-    std::atomic<int> activeWorkers_;
     std::atomic<bool> restartInProgress_{ false };
-    std::atomic<bool> castRequested_{ false };
     DWORD uiThreadId_;
-    bool firstCast;
-    int castCycleId_;
-    int pendingBucketCycleId_;
-    int pendingBucketRetry_;
-    bool pendingBucketSawAttempt_;
-    std::chrono::steady_clock::time_point waitHookStartedAt_;
-    std::chrono::steady_clock::time_point currentCycleStartedAt_;
-    std::chrono::steady_clock::time_point pendingBucketStartedAt_;
-    std::chrono::system_clock::time_point waitHookStartedWallAt_;
-    std::chrono::system_clock::time_point pendingBucketMinEventAt_;
-    std::chrono::system_clock::time_point lastBucketSavedAt_;
-    std::chrono::system_clock::time_point lastHookSavedEventAt_;
-    std::atomic<bool> fishPickupDetected_;
-    std::chrono::steady_clock::time_point fishPickupDetectedAt_;
-
-    struct Stats {
-        int reels;
-        int timeouts;
-        int bucketSuccess;
-        std::chrono::steady_clock::time_point startTime;
-    } stats;
-
-    std::atomic<double> castTime;
-    std::atomic<double> restTime;
-    std::atomic<double> timeoutLimit;
-    std::atomic<bool> randomCastEnabled;
-    std::atomic<double> randomCastMax;
-    std::atomic<bool> noCastMode;
-    std::chrono::steady_clock::time_point detectedTime;
 
     void createControls();
-    std::string getCurrentAction() const;
+    // Cast slider and random cast controls do nothing while the optimizer picks the duration
+    void applyCastOptimizerUI();
+    FishingState getState() const;
     void applyStatusUI();
     void applyStatsUI();
-    bool sleepInterruptible(int totalMs, int stepMs = 100, bool stopOnNotRunning = false);
-    void updateStatus(const std::string& status);
+    void updateStatus();
     void updateTrayIcon();
     void updateStats();
     void updateStatsLoop();
-    void sendClick(bool press);
-    double getCastDuration();
-    void fishingLoop();
-    void requestCast();
-    void performCast();
-    bool performReel(bool isTimeout = false);
-    void forceReel();
-    void onLogEvent(LogEventType eventType, const std::string& line);
-    void fishOnHook(const std::string& line);
-    void fishPickup(const std::string& line);
-    void bucketSave();
-    bool checkFishPickup();
-    bool tryConsumeDeferredBucket(const std::string& line);
-    void startDeferredBucketTracking(int cycleId, const std::optional<std::chrono::system_clock::time_point>& minEventAt);
-    void clearDeferredBucketTracking();
-    bool maybeRecoverMissingBucket();
-    std::optional<std::chrono::system_clock::time_point> extractLogTimestamp(const std::string& line) const;
-    void startTimeoutTimer();
-    void handleTimeout();
-    void startReelTimeoutTimer();
-    void handleReelTimeout();
     std::wstring stringToWString(const std::string& str);
     Language detectSystemLanguage();
-    std::wstring getStatusDisplayText(const std::string& status);
+    std::wstring getStatusDisplayText(FishingState state);
+    std::wstring getPhaseDisplayText(CyclePhase phase);
+    // Writes the phase timings to a timestamped CSV next to config.json
+    void exportPhaseReport();
     std::wstring getText(const std::string& key);
     void registerHotkeys();
     void unregisterHotkeys();
     void loadConfig();
     void saveConfig();
+    // Read ahead of loadConfig(): the OSC client is created before the controls
+    void loadOscTargets();
+    // Listens for the OSC bindings read from config.json, if there are any
+    void startOscServer();
     HICON createColoredIcon(COLORREF color);
 public:
     void setupTrayIcon();
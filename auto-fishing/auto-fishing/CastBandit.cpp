@@ -0,0 +1,69 @@
+#include "CastBandit.h"
+#include <cmath>
+
+namespace {
+// Prior worth half a minute of fishing at two catches per minute, about what
+// a good spot yields, so an untried arm looks as good as a working one
+constexpr double kPriorCatches = 1.0;
+constexpr double kPriorMinutes = 0.5;
+}
+
+CastBandit::CastBandit(double minCastTime, double maxCastTime, double step) {
+    int count = static_cast<int>(std::floor((maxCastTime - minCastTime) / step + 1e-9)) + 1;
+    for (int i = 0; i < count; ++i) {
+        CastArmStats arm;
+        // Rounded to the millisecond so saved arms match exactly
+        arm.castTime = std::round((minCastTime + i * step) * 1000.0) / 1000.0;
+        arms_.push_back(arm);
+    }
+}
+
+size_t CastBandit::choose(std::mt19937_64& random) const {
+    size_t chosen = 0;
+    double bestDraw = -1.0;
+    for (size_t i = 0; i < arms_.size(); ++i) {
+        std::gamma_distribution<double> posterior(kPriorCatches + arms_[i].catches,
+                                                  1.0 / (kPriorMinutes + arms_[i].minutes));
+        double draw = posterior(random);
+        if (draw > bestDraw) {
+            bestDraw = draw;
+            chosen = i;
+        }
+    }
+    return chosen;
+}
+
+void CastBandit::addPull(size_t arm, double minutes) {
+    arms_[arm].pulls++;
+    arms_[arm].minutes += minutes;
+}
+
+void CastBandit::addCatch(size_t arm) {
+    arms_[arm].catches += 1.0;
+}
+
+std::optional<size_t> CastBandit::best() const {
+    std::optional<size_t> best;
+    for (size_t i = 0; i < arms_.size(); ++i) {
+        if (arms_[i].pulls > 0 && (!best || posteriorMean(arms_[i]) > posteriorMean(arms_[*best]))) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void CastBandit::restore(const std::vector<CastArmStats>& saved) {
+    for (const CastArmStats& entry : saved) {
+        for (CastArmStats& arm : arms_) {
+            if (std::abs(arm.castTime - entry.castTime) < 1e-6) {
+                arm.catches = entry.catches;
+                arm.minutes = entry.minutes;
+                arm.pulls = entry.pulls;
+            }
+        }
+    }
+}
+
+double CastBandit::posteriorMean(const CastArmStats& arm) const {
+    return (kPriorCatches + arm.catches) / (kPriorMinutes + arm.minutes);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+// What one cast duration has earned so far
+struct CastArmStats {
+    double castTime = 0.0;
+    // Fish that made it into the bucket after a cast of this duration
+    double catches = 0.0;
+    // Time from those casts to the next cast, timeouts and recoveries included
+    double minutes = 0.0;
+    uint64_t pulls = 0;
+
+    double catchesPerMinute() const { return minutes > 0.0 ? catches / minutes : 0.0; }
+};
+
+// Cast durations on a fixed grid treated as bandit arms, rewarded in catches
+// per minute. Each arm's rate has a Gamma posterior (catches are taken as a
+// Poisson process in fishing time); choose() draws a rate from every posterior
+// and casts the arm with the highest draw, so arms that look worse are tried
+// less and less often but never ruled out.
+class CastBandit {
+public:
+    CastBandit(double minCastTime, double maxCastTime, double step);
+
+    // Arm to cast next
+    size_t choose(std::mt19937_64& random) const;
+    void addPull(size_t arm, double minutes);
+    void addCatch(size_t arm);
+
+    double castTime(size_t arm) const { return arms_[arm].castTime; }
+    const std::vector<CastArmStats>& arms() const { return arms_; }
+    // Arm with the best posterior mean rate, once any arm has been cast
+    std::optional<size_t> best() const;
+    // Takes saved counts for arms whose cast time is still on the grid
+    void restore(const std::vector<CastArmStats>& saved);
+
+private:
+    double posteriorMean(const CastArmStats& arm) const;
+
+    std::vector<CastArmStats> arms_;
+};
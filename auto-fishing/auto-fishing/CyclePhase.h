@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Stretches of one fishing cycle that are timed separately
+enum class CyclePhase : uint8_t {
+    // Button held to charge the cast
+    CastHold,
+    // Line released until a bite is seen or the wait times out
+    BiteWait,
+    // Bite line seen until the reel press goes out
+    HookToPress,
+    // Reel press until the pickup line is seen or the cycle gives up on it
+    PickupDetect,
+    // Pickup seen until the reel is released (FISH_PICKUP_WAIT_TIME)
+    PickupHold,
+    // Reel released until the bucket save is confirmed
+    BucketConfirm,
+    // Reel held after a timed-out wait
+    TimeoutReel,
+    Rest
+};
+
+constexpr size_t kCyclePhaseCount = static_cast<size_t>(CyclePhase::Rest) + 1;
+
+constexpr const char* kCyclePhaseNames[kCyclePhaseCount] = {
+    "CastHold", "BiteWait", "HookToPress", "PickupDetect",
+    "PickupHold", "BucketConfirm", "TimeoutReel", "Rest"
+};
+
+constexpr const char* cyclePhaseName(CyclePhase phase) {
+    return kCyclePhaseNames[static_cast<size_t>(phase)];
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+// Lazily started coroutine used by FishingCycle. It runs on whichever thread
+// resumes it, which for the cycle is always the actor thread, so the cycle
+// body needs no locks. Awaiting a CycleTask runs it to completion and resumes
+// the awaiter afterwards; destroying the top-level task destroys every frame
+// it is suspended in.
+template <typename T>
+class CycleTask;
+
+namespace cycle_task_detail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            std::coroutine_handle<> next = handle.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { exception = std::current_exception(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    CycleTask<T> get_return_object();
+    void return_value(T v) { value = std::move(v); }
+    T result() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    CycleTask<void> get_return_object();
+    void return_void() {}
+    void result() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+} // namespace cycle_task_detail
+
+template <typename T = void>
+class CycleTask {
+public:
+    using promise_type = cycle_task_detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    CycleTask() = default;
+    explicit CycleTask(Handle handle) : handle_(handle) {}
+    CycleTask(CycleTask&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    CycleTask& operator=(CycleTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    CycleTask(const CycleTask&) = delete;
+    CycleTask& operator=(const CycleTask&) = delete;
+    ~CycleTask() { reset(); }
+
+    // Runs a top-level task up to its first suspension
+    void start() { handle_.resume(); }
+    bool valid() const { return static_cast<bool>(handle_); }
+    bool done() const { return !handle_ || handle_.done(); }
+    // Rethrows what the finished task threw, if anything
+    decltype(auto) result() { return handle_.promise().result(); }
+
+    void reset() {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = {};
+        }
+    }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            Handle handle;
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+            decltype(auto) await_resume() { return handle.promise().result(); }
+        };
+        return Awaiter{ handle_ };
+    }
+
+private:
+    Handle handle_;
+};
+
+namespace cycle_task_detail {
+
+template <typename T>
+CycleTask<T> Promise<T>::get_return_object() {
+    return CycleTask<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline CycleTask<void> Promise<void>::get_return_object() {
+    return CycleTask<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+} // namespace cycle_task_detail
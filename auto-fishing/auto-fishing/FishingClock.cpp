@@ -0,0 +1,114 @@
+#include "FishingClock.h"
+#include <algorithm>
+#include <thread>
+
+std::chrono::steady_clock::time_point SystemClock::now() const {
+    return std::chrono::steady_clock::now();
+}
+
+std::chrono::system_clock::time_point SystemClock::wallNow() const {
+    return std::chrono::system_clock::now();
+}
+
+void SystemClock::sleepFor(std::chrono::steady_clock::duration duration) {
+    std::this_thread::sleep_for(duration);
+}
+
+std::cv_status SystemClock::waitUntil(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+                                      std::chrono::steady_clock::time_point deadline) {
+    return cv.wait_until(lock, deadline);
+}
+
+ScaledClock::ScaledClock(double speedup, std::chrono::system_clock::time_point wallOrigin)
+    : speedup_(speedup > 0.0 ? speedup : 1.0)
+    , realOrigin_(std::chrono::steady_clock::now())
+    , wallOrigin_(wallOrigin)
+{
+}
+
+std::chrono::steady_clock::duration ScaledClock::elapsed() const {
+    auto real = std::chrono::steady_clock::now() - realOrigin_;
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(real * speedup_);
+}
+
+std::chrono::steady_clock::time_point ScaledClock::now() const {
+    return realOrigin_ + elapsed();
+}
+
+std::chrono::system_clock::time_point ScaledClock::wallNow() const {
+    return wallOrigin_ + std::chrono::duration_cast<std::chrono::system_clock::duration>(elapsed());
+}
+
+void ScaledClock::sleepFor(std::chrono::steady_clock::duration duration) {
+    if (duration <= std::chrono::steady_clock::duration::zero()) {
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration / speedup_));
+}
+
+std::cv_status ScaledClock::waitUntil(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+                                      std::chrono::steady_clock::time_point deadline) {
+    // Map the scaled deadline back onto the real steady clock
+    auto scaledWait = deadline - now();
+    if (scaledWait <= std::chrono::steady_clock::duration::zero()) {
+        return std::cv_status::timeout;
+    }
+    auto realWait = std::chrono::duration_cast<std::chrono::steady_clock::duration>(scaledWait / speedup_);
+    return cv.wait_until(lock, std::chrono::steady_clock::now() + realWait);
+}
+
+SimulatedClock::SimulatedClock(std::chrono::system_clock::time_point wallOrigin)
+    : steadyOrigin_(std::chrono::steady_clock::now())
+    , wallOrigin_(wallOrigin)
+{
+}
+
+std::chrono::steady_clock::time_point SimulatedClock::now() const {
+    return steadyOrigin_ + std::chrono::steady_clock::duration(elapsed_.load(std::memory_order_acquire));
+}
+
+std::chrono::system_clock::time_point SimulatedClock::wallNow() const {
+    auto elapsed = std::chrono::steady_clock::duration(elapsed_.load(std::memory_order_acquire));
+    return wallOrigin_ + std::chrono::duration_cast<std::chrono::system_clock::duration>(elapsed);
+}
+
+void SimulatedClock::sleepFor(std::chrono::steady_clock::duration duration) {
+    advanceBy(duration);
+}
+
+std::cv_status SimulatedClock::waitUntil(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+                                         std::chrono::steady_clock::time_point deadline) {
+    if (now() >= deadline) {
+        return std::cv_status::timeout;
+    }
+    {
+        std::lock_guard<std::mutex> waitersLock(waitersMutex_);
+        waiters_.push_back(&cv);
+    }
+    // advanceTo() notifies without holding the caller's mutex, so a wakeup can
+    // slip in before wait_for(); the short real timeout bounds that case
+    cv.wait_for(lock, std::chrono::milliseconds(1));
+    {
+        std::lock_guard<std::mutex> waitersLock(waitersMutex_);
+        waiters_.erase(std::find(waiters_.begin(), waiters_.end(), &cv));
+    }
+    return now() >= deadline ? std::cv_status::timeout : std::cv_status::no_timeout;
+}
+
+void SimulatedClock::advanceTo(std::chrono::steady_clock::time_point t) {
+    auto target = (t - steadyOrigin_).count();
+    auto current = elapsed_.load(std::memory_order_relaxed);
+    while (current < target && !elapsed_.compare_exchange_weak(current, target, std::memory_order_acq_rel)) {
+    }
+
+    std::lock_guard<std::mutex> waitersLock(waitersMutex_);
+    for (std::condition_variable* cv : waiters_) {
+        cv->notify_all();
+    }
+}
+
+void SimulatedClock::advanceBy(std::chrono::steady_clock::duration duration) {
+    if (duration > std::chrono::steady_clock::duration::zero()) {
+        advanceTo(now() + duration);
+    }
+}
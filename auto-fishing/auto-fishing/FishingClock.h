@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+// Time source for the fishing cycle. Every wait and every "now" the cycle
+// uses goes through here so it can run faster than real time in replays.
+class FishingClock {
+public:
+    virtual ~FishingClock() = default;
+
+    virtual std::chrono::steady_clock::time_point now() const = 0;
+    virtual std::chrono::system_clock::time_point wallNow() const = 0;
+    virtual void sleepFor(std::chrono::steady_clock::duration duration) = 0;
+    // cv.wait_until() with the deadline read on this clock
+    virtual std::cv_status waitUntil(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+                                     std::chrono::steady_clock::time_point deadline) = 0;
+};
+
+// Real time
+class SystemClock : public FishingClock {
+public:
+    std::chrono::steady_clock::time_point now() const override;
+    std::chrono::system_clock::time_point wallNow() const override;
+    void sleepFor(std::chrono::steady_clock::duration duration) override;
+    std::cv_status waitUntil(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+                             std::chrono::steady_clock::time_point deadline) override;
+};
+
+// Real time sped up by a constant factor. Wall time starts at wallOrigin, so a
+// recorded log can be replayed against its own timestamps.
+class ScaledClock : public FishingClock {
+public:
+    ScaledClock(double speedup, std::chrono::system_clock::time_point wallOrigin);
+
+    std::chrono::steady_clock::time_point now() const override;
+    std::chrono::system_clock::time_point wallNow() const override;
+    void sleepFor(std::chrono::steady_clock::duration duration) override;
+    std::cv_status waitUntil(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+                             std::chrono::steady_clock::time_point deadline) override;
+
+    double speedup() const noexcept { return speedup_; }
+
+private:
+    std::chrono::steady_clock::duration elapsed() const;
+
+    double speedup_;
+    std::chrono::steady_clock::time_point realOrigin_;
+    std::chrono::system_clock::time_point wallOrigin_;
+};
+
+// Virtual time that moves only when advanced, so an hour-long scenario costs
+// no real time. sleepFor() advances the clock itself; waitUntil() blocks until
+// some other thread advances past the deadline. A FishingCycle built on a
+// SimulatedClock runs without threads and is stepped with runUntil().
+class SimulatedClock : public FishingClock {
+public:
+    explicit SimulatedClock(std::chrono::system_clock::time_point wallOrigin);
+
+    std::chrono::steady_clock::time_point now() const override;
+    std::chrono::system_clock::time_point wallNow() const override;
+    void sleepFor(std::chrono::steady_clock::duration duration) override;
+    std::cv_status waitUntil(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+                             std::chrono::steady_clock::time_point deadline) override;
+
+    // Moves time forward to t; earlier times are ignored
+    void advanceTo(std::chrono::steady_clock::time_point t);
+    void advanceBy(std::chrono::steady_clock::duration duration);
+
+private:
+    std::chrono::steady_clock::time_point steadyOrigin_;
+    std::chrono::system_clock::time_point wallOrigin_;
+    std::atomic<std::chrono::steady_clock::rep> elapsed_{ 0 };
+    // Condition variables of threads blocked in waitUntil(), woken on every advance
+    std::mutex waitersMutex_;
+    std::vector<std::condition_variable*> waiters_;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 
 // Fishing Configuration Constants
 class FishingConfig {
@@ -14,13 +15,26 @@ public:
     static constexpr double MIN_TIMEOUT_MINUTES = 0.5;
     static constexpr double MAX_TIMEOUT_MINUTES = 15.0;
 
+    // Adaptive timeout: wait up to this percentile of observed time-to-bite
+    static constexpr double DEFAULT_ADAPTIVE_TIMEOUT_PERCENTILE = 90.0;
+    static constexpr double MIN_ADAPTIVE_TIMEOUT_PERCENTILE = 50.0;
+    static constexpr double MAX_ADAPTIVE_TIMEOUT_PERCENTILE = 99.0;
+    // Waits (bites or timeouts) seen before the estimate replaces the fixed timeout
+    static constexpr int ADAPTIVE_TIMEOUT_MIN_SAMPLES = 10;
+
+    // Cast optimizer: candidate durations from MIN_CAST_TIME to MAX_CAST_TIME in this step
+    static constexpr double CAST_OPTIMIZER_STEP = 0.1;
+
+    // Precise cast timing: sleep until this long before the release, then spin.
+    // Covers Windows' default 15.6ms timer period.
+    static constexpr double PRECISE_HOLD_SPIN_SECONDS = 0.02;
+
     // Detection related constants
     static constexpr double FISH_PICKUP_WAIT_TIME = 2.0;
     static constexpr double FISH_PICKUP_TIMEOUT = 30.0;
     static constexpr double BUCKET_WAIT_TIMEOUT = 10.0;
     static constexpr double TIMEOUT_REEL_WAIT = 10.0;
     static constexpr double RESTART_WAIT_TIME = 2.5;
-    static constexpr double CAST_WAIT_TIME = 3.0;
     static constexpr double FORCE_REEL_REST = 1.0;
     static constexpr double CYCLE_COOLDOWN = 2.0;
 
@@ -29,6 +43,19 @@ public:
     static constexpr double BUCKET_CHECK_INTERVAL = 0.5;
     static constexpr double PICKUP_CHECK_INTERVAL = 0.5;
 
+    // Log read sizes (bytes)
+    static constexpr size_t LOG_READ_CHUNK_BYTES = 64 * 1024;
+    static constexpr size_t LOG_MAX_LINE_BYTES = 1024 * 1024;
+    static constexpr size_t LOG_EVENT_QUEUE_CAPACITY = 256;
+    // Line text kept with each queued event; keyword lines are far shorter
+    static constexpr size_t LOG_EVENT_BODY_BYTES = 512;
+    static constexpr size_t RECENT_EVENT_CAPACITY = 256;
+
+    // OSC input: port VRChat sends avatar parameters to, and how often the
+    // receive thread checks for stop() while no datagram arrives
+    static constexpr int DEFAULT_OSC_LISTEN_PORT = 9001;
+    static constexpr double OSC_RECEIVE_POLL_INTERVAL = 0.1;
+
     // Reel timeout (seconds)
     static constexpr double MAX_REEL_TIME = 30.0;
 
@@ -0,0 +1,875 @@
+#include "FishingCycle.h"
+#include <algorithm>
+#include <exception>
+#include <iomanip>
+#include <random>
+#include <iostream>
+#include <utility>
+
+namespace {
+void joinThreadIfNeeded(std::thread& t) {
+    if (t.joinable() && t.get_id() != std::this_thread::get_id()) {
+        t.join();
+    }
+}
+
+std::chrono::milliseconds secondsToMs(double seconds) {
+    return std::chrono::milliseconds(static_cast<int>(seconds * 1000));
+}
+
+// Log timestamps have second resolution; accept lines printed just before a wait began
+constexpr std::chrono::milliseconds kEventTimeTolerance{ 200 };
+
+PhaseLatency summarize(const LatencyHistogram& histogram) {
+    PhaseLatency latency;
+    latency.count = histogram.count();
+    latency.meanMs = histogram.meanMs();
+    latency.p50Ms = histogram.percentileMs(0.50);
+    latency.p95Ms = histogram.percentileMs(0.95);
+    latency.p99Ms = histogram.percentileMs(0.99);
+    latency.maxMs = histogram.maxMs();
+    return latency;
+}
+}
+
+FishingCycle::FishingCycle(FishingClock& clock, OscSink& osc)
+    : FishingCycle(clock, osc, nullptr) {
+}
+
+FishingCycle::FishingCycle(SimulatedClock& clock, OscSink& osc)
+    : FishingCycle(clock, osc, &clock) {
+}
+
+FishingCycle::FishingCycle(FishingClock& clock, OscSink& osc, SimulatedClock* simulatedClock)
+    : clock_(clock), simulatedClock_(simulatedClock), osc_(osc),
+      diagnostics_(&std::cerr), castRandom_(std::random_device{}()),
+      running(false), exiting_(false),
+      timers_(clock, simulatedClock ? TimerScheduler::Mode::Manual : TimerScheduler::Mode::Threaded),
+      castBandit_(FishingConfig::MIN_CAST_TIME, FishingConfig::MAX_CAST_TIME, FishingConfig::CAST_OPTIMIZER_STEP) {
+    auto nowSteady = clock_.now();
+    auto nowWall = clock_.wallNow();
+    lastCycleEnd = nowSteady;
+    waitHookStartedAt_ = nowSteady;
+    currentCycleStartedAt_ = nowSteady;
+    waitHookStartedWallAt_ = nowWall;
+    lastBucketSavedAt_ = nowWall - std::chrono::seconds(60);
+    lastHookSavedEventAt_ = nowWall - std::chrono::seconds(60);
+    stats.startTime = nowSteady;
+    if (!simulatedClock_) {
+        preciseTimer_ = std::make_unique<PreciseTimer>(clock_,
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(FishingConfig::PRECISE_HOLD_SPIN_SECONDS)));
+        actorThread_ = std::thread(&FishingCycle::actorLoop, this);
+    }
+}
+
+FishingCycle::~FishingCycle() {
+    shutdown();
+}
+
+void FishingCycle::start() {
+    if (exiting_ || running) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> waitLock(waitMutex_);
+        ++runGeneration_;
+        running = true;
+    }
+    Message message{};
+    message.kind = Message::Kind::Start;
+    post(message);
+}
+
+void FishingCycle::stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    cancelWaits();
+    Message message{};
+    message.kind = Message::Kind::Stop;
+    post(message);
+}
+
+void FishingCycle::shutdown() {
+    {
+        std::lock_guard<std::mutex> mailboxLock(mailboxMutex_);
+        exiting_ = true;
+    }
+    running = false;
+    mailboxReady_.notify_one();
+    cancelWaits();
+    timers_.shutdown();
+    if (preciseTimer_) {
+        preciseTimer_->shutdown();
+    }
+    joinThreadIfNeeded(actorThread_);
+    // The actor is gone; a run it never got to stop may still hold the button
+    if (active_ && !actorThread_.joinable()) {
+        active_ = false;
+        cycleTask_.reset();
+        osc_.sendClick(false);
+    }
+}
+
+void FishingCycle::emergencyRelease() {
+    // Not queued behind other messages: the button must come up right away
+    osc_.sendClick(false);
+    Message message{};
+    message.kind = Message::Kind::Release;
+    post(message);
+}
+
+void FishingCycle::onLogEvent(const LogEvent& event) {
+    Message message{};
+    message.kind = Message::Kind::Log;
+    message.event = event;
+    // The line text does not outlive the caller's callback
+    message.event.body = {};
+    post(message);
+}
+
+void FishingCycle::post(Message message) {
+    message.postedAt = clock_.now();
+    {
+        std::lock_guard<std::mutex> mailboxLock(mailboxMutex_);
+        if (exiting_) {
+            return;
+        }
+        mailbox_.push_back(std::move(message));
+        mailboxStats_.maxDepth = (std::max)(mailboxStats_.maxDepth, mailbox_.size());
+    }
+    mailboxReady_.notify_one();
+}
+
+void FishingCycle::actorLoop() {
+    std::unique_lock<std::mutex> mailboxLock(mailboxMutex_);
+    while (true) {
+        mailboxReady_.wait(mailboxLock, [this] { return exiting_ || !mailbox_.empty(); });
+        if (exiting_) {
+            // Messages still queued belong to a cycle that is going away
+            return;
+        }
+
+        Message message = popMessage();
+        mailboxLock.unlock();
+        process(message);
+        mailboxLock.lock();
+    }
+}
+
+void FishingCycle::drainMailbox() {
+    std::unique_lock<std::mutex> mailboxLock(mailboxMutex_);
+    while (!exiting_ && !mailbox_.empty()) {
+        Message message = popMessage();
+        mailboxLock.unlock();
+        process(message);
+        mailboxLock.lock();
+    }
+}
+
+void FishingCycle::runUntil(std::chrono::steady_clock::time_point t) {
+    if (!simulatedClock_) {
+        return;
+    }
+    drainMailbox();
+    while (auto next = timers_.nextDeadline()) {
+        if (*next > t) {
+            break;
+        }
+        simulatedClock_->advanceTo(*next);
+        timers_.runDue();
+        drainMailbox();
+    }
+    simulatedClock_->advanceTo(t);
+}
+
+std::optional<std::chrono::steady_clock::time_point> FishingCycle::nextTimerDeadline() {
+    return simulatedClock_ ? timers_.nextDeadline() : std::nullopt;
+}
+
+FishingCycle::Message FishingCycle::popMessage() {
+    Message message = std::move(mailbox_.front());
+    mailbox_.pop_front();
+
+    double delayMs = std::chrono::duration<double, std::milli>(clock_.now() - message.postedAt).count();
+    mailboxStats_.processed++;
+    mailboxStats_.lastMs = delayMs;
+    mailboxStats_.maxMs = (std::max)(mailboxStats_.maxMs, delayMs);
+    mailboxStats_.totalMs += delayMs;
+    return message;
+}
+
+void FishingCycle::process(const Message& message) {
+    try {
+        handle(message);
+    } catch (const std::exception& e) {
+        if (diagnostics_) {
+            *diagnostics_ << "[FishingCycle] handler failed: " << e.what() << std::endl;
+        }
+    }
+}
+
+void FishingCycle::handle(const Message& message) {
+    switch (message.kind) {
+        case Message::Kind::Start:
+            handleStart();
+            break;
+        case Message::Kind::Stop:
+            handleStop();
+            break;
+        case Message::Kind::Release:
+            transitionTo(FishingState::Stopped);
+            break;
+        case Message::Kind::Log:
+            if (stashLogEvents_ && message.event.type != LogEventType::FishPickup) {
+                stashedEvents_.push_back(message.event);
+            } else {
+                handleLogEvent(message.event);
+            }
+            break;
+        case Message::Kind::Timer:
+            // Stale unless it is the timer the cycle is suspended on
+            if (message.timerToken == 0 || message.timerToken != wakeToken_) {
+                break;
+            }
+            wakeTimer_ = TimerScheduler::INVALID_TIMER;
+            wakeToken_ = 0;
+            wake_.eventType.reset();
+            wake_.accept = nullptr;
+            wake_.event.reset();
+            resumeCycle(std::exchange(wake_.handle, {}));
+            break;
+    }
+}
+
+void FishingCycle::handleLogEvent(const LogEvent& event) {
+    switch (event.type) {
+        case LogEventType::FishOnHook:
+            if (tryConsumeDeferredBucket(event)) {
+                return;
+            }
+            break;
+        case LogEventType::FishPickup:
+            break;
+        case LogEventType::BucketSave:
+            if (pendingBucket_) {
+                pendingBucket_->sawAttempt = true;
+            }
+            return;
+    }
+
+    if (wake_.handle && wake_.eventType == event.type && (!wake_.accept || wake_.accept(event))) {
+        disarmWakeTimer();
+        wake_.eventType.reset();
+        wake_.accept = nullptr;
+        wake_.event = event;
+        resumeCycle(std::exchange(wake_.handle, {}));
+    }
+}
+
+void FishingCycle::unstashLogEvents() {
+    stashLogEvents_ = false;
+    std::vector<LogEvent> stashed;
+    stashed.swap(stashedEvents_);
+    for (const LogEvent& event : stashed) {
+        handleLogEvent(event);
+    }
+}
+
+void FishingCycle::handleStart() {
+    if (active_) {
+        return;
+    }
+    active_ = true;
+    pendingBucket_.reset();
+    stashLogEvents_ = false;
+    stashedEvents_.clear();
+    auto nowSteady = clock_.now();
+    auto nowWall = clock_.wallNow();
+    waitHookStartedAt_ = nowSteady;
+    waitHookStartedWallAt_ = nowWall;
+    lastHookSavedEventAt_ = nowWall - std::chrono::seconds(60);
+    lastBucketSavedAt_ = nowWall - std::chrono::seconds(60);
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        currentCycleStartedAt_ = nowSteady;
+        stats.startTime = nowSteady;
+        for (LatencyHistogram& histogram : phaseTimes_) {
+            histogram.reset();
+        }
+        castHoldError_.reset();
+    }
+    transitionTo(FishingState::Starting);
+    updateStats();
+
+    cycleTask_ = runCycle();
+    cycleTask_.start();
+    reapCycle();
+}
+
+void FishingCycle::handleStop() {
+    if (!active_) {
+        return;
+    }
+    active_ = false;
+    // Destroys every suspended frame of the run
+    cycleTask_.reset();
+    wake_ = Wake{};
+    disarmWakeTimer();
+    if (preciseTimer_) {
+        preciseTimer_->cancel();
+    }
+    stashLogEvents_ = false;
+    stashedEvents_.clear();
+    pendingBucket_.reset();
+    // A cast cut short by the user says nothing about its duration
+    castArm_.reset();
+
+    osc_.sendClick(false);
+    transitionTo(FishingState::Stopped);
+
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats.reels = 0;
+        stats.timeouts = 0;
+        stats.bucketSuccess = 0;
+    }
+    updateStats();
+}
+
+void FishingCycle::resumeCycle(std::coroutine_handle<> handle) {
+    if (handle) {
+        handle.resume();
+    }
+    reapCycle();
+}
+
+void FishingCycle::reapCycle() {
+    if (!cycleTask_.valid() || !cycleTask_.done()) {
+        return;
+    }
+    try {
+        cycleTask_.result();
+    } catch (const std::exception& e) {
+        if (diagnostics_) {
+            *diagnostics_ << "[FishingCycle] cycle failed: " << e.what() << std::endl;
+        }
+    }
+    cycleTask_.reset();
+}
+
+void FishingCycle::armWakeTimer(std::chrono::steady_clock::duration delay) {
+    disarmWakeTimer();
+    wakeToken_ = ++nextWakeToken_;
+    wakeTimer_ = timers_.schedule(delay, [this, token = wakeToken_]() {
+        Message message{};
+        message.kind = Message::Kind::Timer;
+        message.timerToken = token;
+        post(message);
+    });
+}
+
+void FishingCycle::disarmWakeTimer() {
+    if (wakeTimer_ != TimerScheduler::INVALID_TIMER) {
+        timers_.cancel(wakeTimer_);
+    }
+    wakeTimer_ = TimerScheduler::INVALID_TIMER;
+    wakeToken_ = 0;
+}
+
+void FishingCycle::SleepAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    cycle.wake_ = Wake{};
+    cycle.wake_.handle = handle;
+    cycle.armWakeTimer(delay);
+}
+
+void FishingCycle::EventAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    cycle.wake_ = Wake{};
+    cycle.wake_.handle = handle;
+    cycle.wake_.eventType = type;
+    cycle.wake_.accept = std::move(accept);
+    cycle.armWakeTimer(deadline - cycle.clock_.now());
+}
+
+std::optional<LogEvent> FishingCycle::EventAwaiter::await_resume() {
+    return std::exchange(cycle.wake_.event, std::nullopt);
+}
+
+void FishingCycle::ReleaseAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    cycle.wake_ = Wake{};
+    cycle.wake_.handle = handle;
+    cycle.disarmWakeTimer();
+    cycle.wakeToken_ = ++cycle.nextWakeToken_;
+    // Resumed through the mailbox like a timer; a stale token is ignored there
+    cycle.preciseTimer_->fireAt(deadline, [&cycle = cycle, token = cycle.wakeToken_]() {
+        cycle.osc_.sendClick(false);
+        cycle.preciseReleasedAt_ = cycle.clock_.now();
+        Message message{};
+        message.kind = Message::Kind::Timer;
+        message.timerToken = token;
+        cycle.post(message);
+    });
+}
+
+// One run: cast, wait for a bite or the timeout, reel, rest, repeat. Ends only
+// when handleStop() destroys it.
+CycleTask<void> FishingCycle::runCycle() {
+    auto castDueAt = clock_.now();
+    while (active_) {
+        // If bucket is not confirmed within timeout window, force timeout refish.
+        if (bucketRecoveryDue()) {
+            pendingBucket_.reset();
+            if (diagnostics_) {
+                *diagnostics_ << "[BucketRecovery] no-bucket-within-5s => timeout-refish" << std::endl;
+            }
+            countTimeout();
+            transitionTo(FishingState::Timeout);
+            co_await timeoutReel();
+            castDueAt = clock_.now() + secondsToMs(FishingConfig::FORCE_REEL_REST);
+            co_await restFor(secondsToMs(FishingConfig::FORCE_REEL_REST));
+            continue;
+        }
+
+        settleCastArm();
+        recordCastDispatch(castDueAt);
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            currentCycleStartedAt_ = clock_.now();
+        }
+
+        if (!settings_.noCastMode.load()) {
+            transitionTo(FishingState::Casting);
+            double duration = getCastDuration();
+            updateStats();
+
+            co_await castHold(secondsToMs(duration));
+        }
+
+        waitHookStartedAt_ = clock_.now();
+        waitHookStartedWallAt_ = clock_.wallNow();
+        transitionTo(FishingState::WaitingFish);
+
+        double timeoutSeconds = biteTimeoutSeconds();
+        auto timeoutAt = waitHookStartedAt_ + secondsToMs(timeoutSeconds);
+        std::optional<LogEvent> hook = co_await nextEvent(LogEventType::FishOnHook, timeoutAt,
+            [this](const LogEvent& event) { return acceptHook(event); });
+
+        if (!hook) {
+            recordPhase(CyclePhase::BiteWait, waitHookStartedAt_, clock_.now());
+            recordBiteTime(timeoutSeconds, true);
+            transitionTo(FishingState::Timeout);
+            countTimeout();
+            co_await timeoutReel();
+            castDueAt = clock_.now() + secondsToMs(FishingConfig::FORCE_REEL_REST);
+            co_await restFor(secondsToMs(FishingConfig::FORCE_REEL_REST));
+            continue;
+        }
+
+        recordPhase(CyclePhase::BiteWait, waitHookStartedAt_, hook->observedAt);
+        recordBiteTime(std::chrono::duration<double>(hook->observedAt - waitHookStartedAt_).count(), false);
+        lastCycleEnd = clock_.now();
+        lastHookSavedEventAt_ = *hook->timestamp;
+        stashLogEvents_ = true;
+        bool confirmed = co_await hookReel(hook->observedAt);
+
+        if (confirmed) {
+            pendingBucket_ = PendingBucket{ clock_.now(), *hook->timestamp, false, castArm_ };
+        }
+        std::chrono::steady_clock::duration rest = confirmed
+            ? std::chrono::steady_clock::duration(secondsToMs(settings_.restTime.load()))
+            : std::chrono::steady_clock::duration(std::chrono::milliseconds(300));
+        castDueAt = clock_.now() + rest;
+        co_await restFor(rest);
+
+        lastCycleEnd = clock_.now();
+        unstashLogEvents();
+    }
+}
+
+CycleTask<void> FishingCycle::castHold(std::chrono::steady_clock::duration hold) {
+    CastTiming timing = settings_.castTiming.load();
+    if (timing == CastTiming::Timetag) {
+        auto pressWallAt = clock_.wallNow();
+        auto releaseWallAt = pressWallAt + std::chrono::duration_cast<std::chrono::system_clock::duration>(hold);
+        auto sentAt = clock_.now();
+        if (osc_.sendTimedClick(pressWallAt, releaseWallAt)) {
+            // The receiver times the release; how well it does is not visible here
+            co_await sleepFor(hold);
+            recordPhase(CyclePhase::CastHold, sentAt, sentAt + hold);
+            co_return;
+        }
+        timing = CastTiming::Precise;
+    }
+
+    co_await click(true);
+    auto pressedAt = clock_.now();
+    std::chrono::steady_clock::time_point releasedAt;
+    if (timing == CastTiming::Precise && preciseTimer_) {
+        releasedAt = co_await releaseAt(pressedAt + hold);
+    } else {
+        co_await sleepFor(hold);
+        co_await click(false);
+        releasedAt = clock_.now();
+    }
+    recordCastHold(hold, releasedAt - pressedAt);
+}
+
+// Holds the reel until the pickup line plus FISH_PICKUP_WAIT_TIME; true if the fish was landed
+CycleTask<bool> FishingCycle::hookReel(std::chrono::steady_clock::time_point hookObservedAt) {
+    transitionTo(FishingState::Reeling);
+    countReel();
+    co_await click(true);
+
+    auto reelStartedAt = clock_.now();
+    recordPhase(CyclePhase::HookToPress, hookObservedAt, reelStartedAt);
+    std::optional<std::chrono::steady_clock::time_point> detectedAt;
+
+    // A pickup line ingested before the hook was handled never reaches the waiter below
+    uint64_t pickupCursor = 0;
+    if (recentEventLookup_
+        && recentEventLookup_(LogEventType::FishPickup, waitHookStartedWallAt_ - kEventTimeTolerance, pickupCursor)) {
+        detectedAt = reelStartedAt;
+    } else {
+        auto deadline = reelStartedAt
+            + secondsToMs((std::min)(FishingConfig::FISH_PICKUP_TIMEOUT, FishingConfig::MAX_REEL_TIME));
+        std::optional<LogEvent> pickup = co_await nextEvent(LogEventType::FishPickup, deadline,
+            [this](const LogEvent& event) { return acceptPickup(event); });
+        if (pickup) {
+            detectedAt = pickup->observedAt;
+        }
+    }
+
+    recordPhase(CyclePhase::PickupDetect, reelStartedAt, detectedAt.value_or(clock_.now()));
+    if (detectedAt) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(clock_.now() - *detectedAt).count() / 1000.0;
+        double remaining = (std::max)(0.0, FishingConfig::FISH_PICKUP_WAIT_TIME - elapsed);
+        co_await sleepFor(secondsToMs(remaining));
+    }
+
+    co_await click(false);
+    if (detectedAt) {
+        recordPhase(CyclePhase::PickupHold, *detectedAt, clock_.now());
+    }
+    co_return detectedAt.has_value();
+}
+
+CycleTask<void> FishingCycle::timeoutReel() {
+    transitionTo(FishingState::Reeling);
+    countReel();
+    auto pressedAt = clock_.now();
+    co_await click(true);
+    co_await sleepFor(secondsToMs((std::min)(FishingConfig::TIMEOUT_REEL_WAIT, FishingConfig::MAX_REEL_TIME)));
+    co_await click(false);
+    recordPhase(CyclePhase::TimeoutReel, pressedAt, clock_.now());
+}
+
+CycleTask<void> FishingCycle::restFor(std::chrono::steady_clock::duration duration) {
+    transitionTo(FishingState::Resting);
+    auto restStartedAt = clock_.now();
+    co_await sleepFor(duration);
+    recordPhase(CyclePhase::Rest, restStartedAt, clock_.now());
+}
+
+FishingCycle::WaitResult FishingCycle::waitFor(std::chrono::steady_clock::duration duration, const std::function<bool()>& until) {
+    std::unique_lock<std::mutex> waitLock(waitMutex_);
+    const bool tiedToRun = running;
+    const uint64_t generation = runGeneration_;
+    const auto deadline = clock_.now() + duration;
+    while (true) {
+        if (exiting_ || (tiedToRun && runGeneration_ != generation)) {
+            return WaitResult::Cancelled;
+        }
+        if (until && until()) {
+            return WaitResult::Satisfied;
+        }
+        if (clock_.now() >= deadline) {
+            return WaitResult::Elapsed;
+        }
+        clock_.waitUntil(waitWake_, waitLock, deadline);
+    }
+}
+
+void FishingCycle::cancelWaits() {
+    {
+        std::lock_guard<std::mutex> waitLock(waitMutex_);
+        ++runGeneration_;
+    }
+    waitWake_.notify_all();
+}
+
+FishingStats FishingCycle::getStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return stats;
+}
+
+CastDispatchStats FishingCycle::getCastDispatchStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return castDispatch_;
+}
+
+MailboxStats FishingCycle::getMailboxStats() const {
+    std::lock_guard<std::mutex> mailboxLock(mailboxMutex_);
+    return mailboxStats_;
+}
+
+BiteTimeStats FishingCycle::getBiteTimeStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return biteTimeStats_;
+}
+
+std::vector<CastArmStats> FishingCycle::getCastArms() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return castBandit_.arms();
+}
+
+std::optional<CastArmStats> FishingCycle::getBestCastArm() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    if (auto best = castBandit_.best()) {
+        return castBandit_.arms()[*best];
+    }
+    return std::nullopt;
+}
+
+void FishingCycle::restoreCastArms(const std::vector<CastArmStats>& arms) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    castBandit_.restore(arms);
+}
+
+std::array<PhaseLatency, kCyclePhaseCount> FishingCycle::getPhaseLatencies() const {
+    std::array<PhaseLatency, kCyclePhaseCount> latencies;
+    std::lock_guard<std::mutex> lock(statsMutex);
+    for (size_t i = 0; i < kCyclePhaseCount; ++i) {
+        latencies[i] = summarize(phaseTimes_[i]);
+    }
+    return latencies;
+}
+
+PhaseLatency FishingCycle::getCastHoldError() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return summarize(castHoldError_);
+}
+
+void FishingCycle::writePhaseReport(std::ostream& out) const {
+    out << "# castTime=" << settings_.castTime.load()
+        << " randomCastEnabled=" << settings_.randomCastEnabled.load()
+        << " randomCastMax=" << settings_.randomCastMax.load()
+        << " castOptimizerEnabled=" << settings_.castOptimizerEnabled.load()
+        << " noCastMode=" << settings_.noCastMode.load()
+        << " castTiming=" << kCastTimingNames[static_cast<size_t>(settings_.castTiming.load())]
+        << " restTime=" << settings_.restTime.load()
+        << " timeoutLimit=" << settings_.timeoutLimit.load()
+        << " adaptiveTimeout=" << settings_.adaptiveTimeout.load()
+        << " adaptiveTimeoutPercentile=" << settings_.adaptiveTimeoutPercentile.load() << "\n";
+    out << "phase,count,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+
+    std::array<PhaseLatency, kCyclePhaseCount> latencies = getPhaseLatencies();
+    auto writeRow = [&out](const char* name, const PhaseLatency& latency) {
+        out << name << ',' << latency.count << ',' << latency.meanMs << ','
+            << latency.p50Ms << ',' << latency.p95Ms << ',' << latency.p99Ms << ',' << latency.maxMs << "\n";
+    };
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < kCyclePhaseCount; ++i) {
+        writeRow(kCyclePhaseNames[i], latencies[i]);
+    }
+    // Distance of each achieved cast hold from the requested one
+    writeRow("CastHoldError", getCastHoldError());
+    out.flags(flags);
+    out.precision(precision);
+}
+
+std::chrono::steady_clock::time_point FishingCycle::getCycleStartedAt() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return currentCycleStartedAt_;
+}
+
+bool FishingCycle::transitionTo(FishingState next) {
+    FishingState current = state_.load(std::memory_order_relaxed);
+    if (!isFishingTransitionAllowed(current, next)) {
+        if (diagnostics_) {
+            *diagnostics_ << "[FSM] rejected " << fishingStateName(current)
+                          << " -> " << fishingStateName(next) << std::endl;
+        }
+        return false;
+    }
+    state_.store(next, std::memory_order_release);
+
+    if (statusCallback_) {
+        statusCallback_(next);
+    }
+    return true;
+}
+
+void FishingCycle::updateStats() {
+    if (statsCallback_) {
+        statsCallback_();
+    }
+}
+
+void FishingCycle::countReel() {
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats.reels++;
+    }
+    updateStats();
+}
+
+void FishingCycle::countTimeout() {
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats.timeouts++;
+    }
+    updateStats();
+}
+
+void FishingCycle::recordCastDispatch(std::chrono::steady_clock::time_point dueAt) {
+    double latencyMs = (std::max)(0.0, std::chrono::duration<double, std::milli>(clock_.now() - dueAt).count());
+    std::lock_guard<std::mutex> lock(statsMutex);
+    castDispatch_.count++;
+    castDispatch_.lastMs = latencyMs;
+    castDispatch_.maxMs = (std::max)(castDispatch_.maxMs, latencyMs);
+    castDispatch_.totalMs += latencyMs;
+}
+
+double FishingCycle::biteTimeoutSeconds() {
+    double percentile = std::clamp(settings_.adaptiveTimeoutPercentile.load(),
+        FishingConfig::MIN_ADAPTIVE_TIMEOUT_PERCENTILE, FishingConfig::MAX_ADAPTIVE_TIMEOUT_PERCENTILE);
+    bool restarted = percentile / 100.0 != biteTimes_.probability();
+    if (restarted) {
+        biteTimes_ = P2Quantile(percentile / 100.0);
+    }
+
+    double timeout = settings_.timeoutLimit.load() * 60;
+    double estimate = biteTimes_.count() >= FishingConfig::ADAPTIVE_TIMEOUT_MIN_SAMPLES ? biteTimes_.estimate() : 0.0;
+    if (settings_.adaptiveTimeout.load() && estimate > 0.0) {
+        timeout = std::clamp(estimate, FishingConfig::MIN_TIMEOUT_MINUTES * 60, FishingConfig::MAX_TIMEOUT_MINUTES * 60);
+    }
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    if (restarted) {
+        biteTimeStats_.bites = 0;
+        biteTimeStats_.censored = 0;
+    }
+    biteTimeStats_.percentile = percentile;
+    biteTimeStats_.estimateSeconds = estimate;
+    biteTimeStats_.timeoutSeconds = timeout;
+    return timeout;
+}
+
+void FishingCycle::recordCastHold(std::chrono::steady_clock::duration requested,
+                                  std::chrono::steady_clock::duration achieved) {
+    auto error = achieved > requested ? achieved - requested : requested - achieved;
+    std::lock_guard<std::mutex> lock(statsMutex);
+    phaseTimes_[static_cast<size_t>(CyclePhase::CastHold)].record(achieved);
+    castHoldError_.record(error);
+}
+
+void FishingCycle::recordPhase(CyclePhase phase, std::chrono::steady_clock::time_point from,
+                               std::chrono::steady_clock::time_point to) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    phaseTimes_[static_cast<size_t>(phase)].record(to - from);
+}
+
+void FishingCycle::recordBiteTime(double seconds, bool timedOut) {
+    // A timed-out wait only says the bite would have come later. Counting it
+    // a quarter past the limit lets the estimate climb while too many waits
+    // time out, and leaves it alone while most bites come before the limit.
+    biteTimes_.add(timedOut ? (std::min)(1.25 * seconds, FishingConfig::MAX_TIMEOUT_MINUTES * 60) : seconds);
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    (timedOut ? biteTimeStats_.censored : biteTimeStats_.bites)++;
+    if (biteTimes_.count() >= FishingConfig::ADAPTIVE_TIMEOUT_MIN_SAMPLES) {
+        biteTimeStats_.estimateSeconds = biteTimes_.estimate();
+    }
+}
+
+double FishingCycle::getCastDuration() {
+    if (settings_.castOptimizerEnabled.load()) {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        castArm_ = castBandit_.choose(castRandom_);
+        castArmStartedAt_ = clock_.now();
+        return castBandit_.castTime(*castArm_);
+    }
+    if (settings_.randomCastEnabled.load()) {
+        std::uniform_real_distribution<> dis(FishingConfig::MIN_CAST_TIME, settings_.randomCastMax.load());
+        return dis(castRandom_);
+    }
+    return settings_.castTime.load();
+}
+
+void FishingCycle::settleCastArm() {
+    if (!castArm_) {
+        return;
+    }
+    double minutes = std::chrono::duration<double, std::ratio<60>>(clock_.now() - castArmStartedAt_).count();
+    std::lock_guard<std::mutex> lock(statsMutex);
+    castBandit_.addPull(*castArm_, minutes);
+    castArm_.reset();
+}
+
+bool FishingCycle::acceptHook(const LogEvent& event) const {
+    const auto& eventTime = event.timestamp;
+    if (!eventTime) {
+        return false;
+    }
+
+    auto nowSteady = clock_.now();
+    auto elapsedSinceCycle = std::chrono::duration_cast<std::chrono::seconds>(nowSteady - lastCycleEnd).count();
+    if (elapsedSinceCycle < FishingConfig::CYCLE_COOLDOWN) {
+        return false;
+    }
+
+    auto sinceWait = std::chrono::duration_cast<std::chrono::milliseconds>(nowSteady - waitHookStartedAt_).count() / 1000.0;
+    if (sinceWait < FishingConfig::HOOK_MIN_WAIT_SECONDS) {
+        return false;
+    }
+
+    if (std::chrono::duration_cast<std::chrono::milliseconds>(*eventTime - lastBucketSavedAt_).count() / 1000.0
+        <= FishingConfig::BUCKET_EVENT_COOLDOWN_SECONDS) {
+        return false;
+    }
+
+    if (std::chrono::duration_cast<std::chrono::milliseconds>(*eventTime - lastHookSavedEventAt_).count() / 1000.0
+        <= FishingConfig::SAVED_DATA_CLUSTER_SECONDS) {
+        return false;
+    }
+
+    return *eventTime >= waitHookStartedWallAt_ - kEventTimeTolerance;
+}
+
+bool FishingCycle::acceptPickup(const LogEvent& event) const {
+    return !event.timestamp || *event.timestamp >= waitHookStartedWallAt_ - kEventTimeTolerance;
+}
+
+bool FishingCycle::tryConsumeDeferredBucket(const LogEvent& event) {
+    const auto& eventTime = event.timestamp;
+    if (!active_ || !pendingBucket_ || !pendingBucket_->sawAttempt || !eventTime
+        || *eventTime < pendingBucket_->minEventAt) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats.bucketSuccess++;
+        phaseTimes_[static_cast<size_t>(CyclePhase::BucketConfirm)].record(clock_.now() - pendingBucket_->startedAt);
+        if (pendingBucket_->castArm) {
+            castBandit_.addCatch(*pendingBucket_->castArm);
+        }
+    }
+    updateStats();
+
+    lastBucketSavedAt_ = *eventTime;
+    pendingBucket_.reset();
+    return true;
+}
+
+bool FishingCycle::bucketRecoveryDue() const {
+    if (!pendingBucket_) {
+        return false;
+    }
+    double elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(clock_.now() - pendingBucket_->startedAt).count() / 1000.0;
+    return elapsed >= FishingConfig::BUCKET_SAVE_TIMEOUT_SECONDS;
+}
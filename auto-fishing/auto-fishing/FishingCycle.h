@@ -0,0 +1,378 @@
+#pragma once
+#include "CastBandit.h"
+#include "CyclePhase.h"
+#include "CycleTask.h"
+#include "FishingClock.h"
+#include "FishingConfig.h"
+#include "FishingState.h"
+#include "LatencyHistogram.h"
+#include "LogEvent.h"
+#include "OscSink.h"
+#include "P2Quantile.h"
+#include "PreciseTimer.h"
+#include "TimerScheduler.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct FishingStats {
+    int reels = 0;
+    int timeouts = 0;
+    int bucketSuccess = 0;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+// Delay between a cast falling due and the cycle pressing for it
+struct CastDispatchStats {
+    uint64_t count = 0;
+    double lastMs = 0.0;
+    double maxMs = 0.0;
+    double totalMs = 0.0;
+
+    double meanMs() const { return count ? totalMs / count : 0.0; }
+};
+
+// How a cast's release is timed against its press
+enum class CastTiming : uint8_t {
+    // When the cycle's timer fires; late by however long the OS oversleeps
+    Timer,
+    // From a dedicated thread that sleeps most of the hold and spins the rest
+    Precise,
+    // Press and release sent together in an OSC bundle time-tagged for each.
+    // Only for receivers that honor time tags; falls back to Precise when the
+    // sink cannot send one.
+    Timetag
+};
+
+constexpr size_t kCastTimingCount = static_cast<size_t>(CastTiming::Timetag) + 1;
+
+// Names used in config.json
+constexpr const char* kCastTimingNames[kCastTimingCount] = { "timer", "precise", "timetag" };
+
+// User-adjustable parameters; read by the cycle on every use
+struct FishingSettings {
+    std::atomic<double> castTime{ FishingConfig::DEFAULT_CAST_TIME };
+    std::atomic<double> restTime{ FishingConfig::DEFAULT_REST_TIME };
+    std::atomic<double> timeoutLimit{ FishingConfig::DEFAULT_TIMEOUT_MINUTES };
+    std::atomic<bool> randomCastEnabled{ false };
+    std::atomic<double> randomCastMax{ 1.0 };
+    // Learn which cast duration lands the most fish per minute; overrides the two above
+    std::atomic<bool> castOptimizerEnabled{ false };
+    std::atomic<bool> noCastMode{ false };
+    std::atomic<CastTiming> castTiming{ CastTiming::Timer };
+    // Wait for a bite up to a percentile of the bite times seen so far instead of timeoutLimit
+    std::atomic<bool> adaptiveTimeout{ false };
+    std::atomic<double> adaptiveTimeoutPercentile{ FishingConfig::DEFAULT_ADAPTIVE_TIMEOUT_PERCENTILE };
+};
+
+// Time from the line landing to a bite, and the wait limit derived from it
+struct BiteTimeStats {
+    uint64_t bites = 0;
+    // Waits that timed out; the bite would have come later than the limit
+    uint64_t censored = 0;
+    double percentile = FishingConfig::DEFAULT_ADAPTIVE_TIMEOUT_PERCENTILE;
+    // Estimated percentile of time-to-bite, 0 until enough bites are seen
+    double estimateSeconds = 0.0;
+    // Limit applied to the current or next wait
+    double timeoutSeconds = FishingConfig::DEFAULT_TIMEOUT_MINUTES * 60.0;
+};
+
+// Distribution of one cycle phase's durations since the run started
+struct PhaseLatency {
+    uint64_t count = 0;
+    double meanMs = 0.0;
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+// Time spent in the actor's mailbox, from post to handling
+struct MailboxStats {
+    uint64_t processed = 0;
+    size_t maxDepth = 0;
+    double lastMs = 0.0;
+    double maxMs = 0.0;
+    double totalMs = 0.0;
+
+    double meanMs() const { return processed ? totalMs / processed : 0.0; }
+};
+
+// Cast / wait / reel / bucket cycle driven by log events. Has no Windows
+// dependency: time comes from a FishingClock and clicks go to an OscSink, so
+// the same logic runs in the GUI and in the headless replay tool.
+//
+// The cycle is an actor: one thread owns all of its state and handles a single
+// mailbox of start/stop commands, log events and timer fires, in order. Each
+// run is one coroutine (runCycle) executed by that thread; it suspends on
+// "sleep for d" and "next log event of type X before a deadline", and the
+// actor resumes it when the timer fires or the event arrives. Other threads
+// only post messages and read published snapshots.
+class FishingCycle {
+public:
+    using StatusCallback = std::function<void(FishingState)>;
+    using StatsCallback = std::function<void()>;
+    // Looks for an already-ingested event of the given type at or after minTime
+    using RecentEventLookup = std::function<bool(LogEventType, std::chrono::system_clock::time_point, uint64_t&)>;
+
+    FishingCycle(FishingClock& clock, OscSink& osc);
+    // Runs without threads of its own on simulated time; drive it with runUntil()
+    FishingCycle(SimulatedClock& clock, OscSink& osc);
+    ~FishingCycle();
+
+    FishingCycle(const FishingCycle&) = delete;
+    FishingCycle& operator=(const FishingCycle&) = delete;
+
+    // Observers are called on the actor thread and must not block; set them before start()
+    void setStatusCallback(StatusCallback callback) { statusCallback_ = std::move(callback); }
+    void setStatsCallback(StatsCallback callback) { statsCallback_ = std::move(callback); }
+    void setRecentEventLookup(RecentEventLookup lookup) { recentEventLookup_ = std::move(lookup); }
+    // Where [FSM] / [BucketRecovery] notes go (std::cerr by default); nullptr silences them
+    void setDiagnosticStream(std::ostream* stream) { diagnostics_ = stream; }
+    // Makes random cast durations reproducible; call before start()
+    void seedRandomCast(uint64_t seed) { castRandom_.seed(seed); }
+
+    void start();
+    void stop();
+    // Stops the cycle for good and joins its workers
+    void shutdown();
+    // The last start/stop command; the actor catches up in mailbox order
+    bool isRunning() const { return running; }
+
+    // Queues the event for the actor; never blocks on the cycle
+    void onLogEvent(const LogEvent& event);
+    // Releases the button from the calling thread, then tells the actor
+    void emergencyRelease();
+
+    enum class WaitResult { Elapsed, Satisfied, Cancelled };
+
+    // Cancellable delay for threads outside the actor. Waits on the cycle's
+    // clock and returns Cancelled as soon as the cycle shuts down, or, for a
+    // wait begun while running, as soon as that run is stopped. Returns
+    // Satisfied early once until() holds.
+    WaitResult waitFor(std::chrono::steady_clock::duration duration, const std::function<bool()>& until = nullptr);
+
+    // Simulated cycles only: handles queued messages and fires timers in
+    // deadline order, jumping the clock from one deadline to the next, up to t
+    void runUntil(std::chrono::steady_clock::time_point t);
+    // Simulated cycles only: when the next timer fires, or nullopt when none is armed
+    std::optional<std::chrono::steady_clock::time_point> nextTimerDeadline();
+
+    FishingSettings& settings() { return settings_; }
+    FishingClock& clock() { return clock_; }
+    FishingState getState() const { return state_.load(std::memory_order_acquire); }
+    FishingStats getStats() const;
+    CastDispatchStats getCastDispatchStats() const;
+    MailboxStats getMailboxStats() const;
+    BiteTimeStats getBiteTimeStats() const;
+    // What the cast optimizer has learned, for display and for saving
+    std::vector<CastArmStats> getCastArms() const;
+    std::optional<CastArmStats> getBestCastArm() const;
+    std::array<PhaseLatency, kCyclePhaseCount> getPhaseLatencies() const;
+    // How far achieved cast holds were from the requested duration
+    PhaseLatency getCastHoldError() const;
+    // Current settings as a comment line, then one CSV row per phase
+    void writePhaseReport(std::ostream& out) const;
+    // Seeds the optimizer with counts saved by an earlier session
+    void restoreCastArms(const std::vector<CastArmStats>& arms);
+    std::chrono::steady_clock::time_point getCycleStartedAt() const;
+
+private:
+    struct Message {
+        enum class Kind : uint8_t { Start, Stop, Release, Log, Timer };
+        Kind kind;
+        uint64_t timerToken;
+        LogEvent event;
+        std::chrono::steady_clock::time_point postedAt;
+    };
+
+    // Outstanding deliveries a suspended cycle can be resumed by
+    struct Wake {
+        std::coroutine_handle<> handle;
+        std::optional<LogEventType> eventType;
+        std::function<bool(const LogEvent&)> accept;
+        std::optional<LogEvent> event;
+    };
+
+    struct SleepAwaiter {
+        FishingCycle& cycle;
+        std::chrono::steady_clock::duration delay;
+        bool await_ready() const { return delay <= std::chrono::steady_clock::duration::zero(); }
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const {}
+    };
+
+    struct EventAwaiter {
+        FishingCycle& cycle;
+        LogEventType type;
+        std::chrono::steady_clock::time_point deadline;
+        std::function<bool(const LogEvent&)> accept;
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        std::optional<LogEvent> await_resume();
+    };
+
+    // Has the precise timer release the button at a deadline; resumes with when it did
+    struct ReleaseAwaiter {
+        FishingCycle& cycle;
+        std::chrono::steady_clock::time_point deadline;
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        std::chrono::steady_clock::time_point await_resume() const { return cycle.preciseReleasedAt_; }
+    };
+
+    // Sends immediately; awaiting it keeps clicks in line with the cycle's steps
+    struct ClickAwaiter {
+        FishingCycle& cycle;
+        bool press;
+        bool await_ready() const { return true; }
+        void await_suspend(std::coroutine_handle<>) const {}
+        bool await_resume() const { return cycle.osc_.sendClick(press); }
+    };
+
+    SleepAwaiter sleepFor(std::chrono::steady_clock::duration delay) { return { *this, delay }; }
+    // Resumes with the first event of the type accept() agrees to, or nullopt at the deadline
+    EventAwaiter nextEvent(LogEventType type, std::chrono::steady_clock::time_point deadline,
+                           std::function<bool(const LogEvent&)> accept = nullptr) {
+        return { *this, type, deadline, std::move(accept) };
+    }
+    ClickAwaiter click(bool press) { return { *this, press }; }
+    ReleaseAwaiter releaseAt(std::chrono::steady_clock::time_point deadline) { return { *this, deadline }; }
+
+    CycleTask<void> runCycle();
+    // Presses, holds and releases, timed as settings().castTiming asks
+    CycleTask<void> castHold(std::chrono::steady_clock::duration hold);
+    CycleTask<bool> hookReel(std::chrono::steady_clock::time_point hookObservedAt);
+    CycleTask<void> timeoutReel();
+    CycleTask<void> restFor(std::chrono::steady_clock::duration duration);
+
+    FishingCycle(FishingClock& clock, OscSink& osc, SimulatedClock* simulatedClock);
+
+    void post(Message message);
+    void actorLoop();
+    // Handles every queued message on the calling thread
+    void drainMailbox();
+    // Takes the oldest message and records its queueing delay; needs mailboxMutex_
+    Message popMessage();
+    void process(const Message& message);
+    void handle(const Message& message);
+    void handleStart();
+    void handleStop();
+    void handleLogEvent(const LogEvent& event);
+    void unstashLogEvents();
+    void armWakeTimer(std::chrono::steady_clock::duration delay);
+    void disarmWakeTimer();
+    void resumeCycle(std::coroutine_handle<> handle);
+    // Drops the run's task once it has finished, logging what it threw
+    void reapCycle();
+
+    // Moves to next if the transition table allows it; rejected moves are logged
+    bool transitionTo(FishingState next);
+    void updateStats();
+    void countReel();
+    void countTimeout();
+    void recordCastDispatch(std::chrono::steady_clock::time_point dueAt);
+    // How long the wait for a bite that is about to start may last
+    double biteTimeoutSeconds();
+    void recordBiteTime(double seconds, bool timedOut);
+    void recordCastHold(std::chrono::steady_clock::duration requested, std::chrono::steady_clock::duration achieved);
+    void recordPhase(CyclePhase phase, std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to);
+    double getCastDuration();
+    // Charges the time since the last optimized cast to its arm
+    void settleCastArm();
+    void cancelWaits();
+    bool acceptHook(const LogEvent& event) const;
+    bool acceptPickup(const LogEvent& event) const;
+    bool tryConsumeDeferredBucket(const LogEvent& event);
+    bool bucketRecoveryDue() const;
+
+    FishingClock& clock_;
+    // Set when the cycle is stepped by runUntil() instead of its own threads
+    SimulatedClock* simulatedClock_;
+    OscSink& osc_;
+    FishingSettings settings_;
+    StatusCallback statusCallback_;
+    StatsCallback statsCallback_;
+    RecentEventLookup recentEventLookup_;
+    std::ostream* diagnostics_;
+    std::mt19937_64 castRandom_;
+
+    std::atomic<bool> running;
+    std::atomic<bool> exiting_;
+    // Written only by the actor
+    std::atomic<FishingState> state_{ FishingState::Waiting };
+    TimerScheduler timers_;
+
+    // Mailbox; the only lock the actor takes per message
+    mutable std::mutex mailboxMutex_;
+    std::condition_variable mailboxReady_;
+    std::deque<Message> mailbox_;
+    MailboxStats mailboxStats_;
+
+    // Published for other threads; written by the actor under statsMutex
+    mutable std::mutex statsMutex;
+    FishingStats stats;
+    CastDispatchStats castDispatch_;
+    BiteTimeStats biteTimeStats_;
+    CastBandit castBandit_;
+    // Cleared when a run starts, so one run's settings can be compared with the next
+    std::array<LatencyHistogram, kCyclePhaseCount> phaseTimes_;
+    LatencyHistogram castHoldError_;
+    std::chrono::steady_clock::time_point currentCycleStartedAt_;
+
+    // Cancellable waits; runGeneration_ changes on every start and stop
+    std::mutex waitMutex_;
+    std::condition_variable waitWake_;
+    uint64_t runGeneration_ = 0;
+
+    // Everything below is owned by the actor thread
+    bool active_ = false;
+    CycleTask<void> cycleTask_;
+    Wake wake_;
+    TimerScheduler::TimerId wakeTimer_ = TimerScheduler::INVALID_TIMER;
+    uint64_t wakeToken_ = 0;
+    uint64_t nextWakeToken_ = 0;
+    // Hook and bucket lines that arrive during a hook reel and its rest are
+    // handled once the rest ends, after bucket tracking for that catch began
+    bool stashLogEvents_ = false;
+    std::vector<LogEvent> stashedEvents_;
+    // A caught fish whose bucket save has not been confirmed yet
+    struct PendingBucket {
+        std::chrono::steady_clock::time_point startedAt;
+        std::chrono::system_clock::time_point minEventAt;
+        bool sawAttempt = false;
+        // Optimizer arm of the cast that caught it
+        std::optional<size_t> castArm;
+    };
+    std::optional<PendingBucket> pendingBucket_;
+    // Time-to-bite sketch; restarted when the percentile setting changes
+    P2Quantile biteTimes_{ FishingConfig::DEFAULT_ADAPTIVE_TIMEOUT_PERCENTILE / 100.0 };
+    // Optimizer arm of the cast in progress and when it was cast
+    std::optional<size_t> castArm_;
+    std::chrono::steady_clock::time_point castArmStartedAt_;
+    std::chrono::steady_clock::time_point lastCycleEnd;
+    std::chrono::steady_clock::time_point waitHookStartedAt_;
+    std::chrono::system_clock::time_point waitHookStartedWallAt_;
+    std::chrono::system_clock::time_point lastBucketSavedAt_;
+    std::chrono::system_clock::time_point lastHookSavedEventAt_;
+    // Written by the precise timer thread before it posts the wake message
+    std::chrono::steady_clock::time_point preciseReleasedAt_;
+
+    // Real-time cycles only; releases casts for CastTiming::Precise
+    std::unique_ptr<PreciseTimer> preciseTimer_;
+    // Started last, once every member above is constructed
+    std::thread actorThread_;
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+enum class FishingState : uint8_t {
+    Waiting,
+    Starting,
+    Casting,
+    WaitingFish,
+    Reeling,
+    WaitingBucket,
+    Resting,
+    Timeout,
+    Stopped
+};
+
+constexpr size_t kFishingStateCount = static_cast<size_t>(FishingState::Stopped) + 1;
+
+constexpr uint16_t fishingStateBit(FishingState state) {
+    return static_cast<uint16_t>(1u << static_cast<unsigned>(state));
+}
+
+// Legal targets for each state, indexed by the source state. Any state may
+// move to Stopped and re-entering the current state is always allowed.
+constexpr uint16_t kFishingTransitions[kFishingStateCount] = {
+    /* Waiting       */ fishingStateBit(FishingState::Starting),
+    /* Starting      */ fishingStateBit(FishingState::Casting) | fishingStateBit(FishingState::WaitingFish)
+                        | fishingStateBit(FishingState::Timeout),
+    /* Casting       */ fishingStateBit(FishingState::WaitingFish),
+    /* WaitingFish   */ fishingStateBit(FishingState::Reeling) | fishingStateBit(FishingState::Timeout),
+    /* Reeling       */ fishingStateBit(FishingState::Resting) | fishingStateBit(FishingState::WaitingBucket),
+    /* WaitingBucket */ fishingStateBit(FishingState::Resting) | fishingStateBit(FishingState::Casting)
+                        | fishingStateBit(FishingState::WaitingFish) | fishingStateBit(FishingState::Timeout),
+    /* Resting       */ fishingStateBit(FishingState::Casting) | fishingStateBit(FishingState::WaitingFish)
+                        | fishingStateBit(FishingState::Timeout),
+    /* Timeout       */ fishingStateBit(FishingState::Reeling) | fishingStateBit(FishingState::Casting)
+                        | fishingStateBit(FishingState::WaitingFish),
+    /* Stopped       */ fishingStateBit(FishingState::Starting),
+};
+
+constexpr bool isFishingTransitionAllowed(FishingState from, FishingState to) {
+    return from == to || to == FishingState::Stopped
+        || (kFishingTransitions[static_cast<size_t>(from)] & fishingStateBit(to)) != 0;
+}
+
+constexpr const char* kFishingStateNames[kFishingStateCount] = {
+    "Waiting", "Starting", "Casting", "WaitingFish", "Reeling",
+    "WaitingBucket", "Resting", "Timeout", "Stopped"
+};
+
+constexpr const char* fishingStateName(FishingState state) {
+    return kFishingStateNames[static_cast<size_t>(state)];
+}
@@ -0,0 +1,161 @@
+#include "KeywordMatcher.h"
+#include "SimdSupport.h"
+#include <deque>
+
+namespace {
+constexpr std::int32_t kNoState = -1;
+}
+
+int KeywordMatcher::addPattern(std::string_view pattern) {
+    if (compiled_ || pattern.empty() || patterns_.size() >= MAX_PATTERNS) {
+        return -1;
+    }
+    patterns_.emplace_back(pattern);
+    return static_cast<int>(patterns_.size() - 1);
+}
+
+void KeywordMatcher::compile() {
+    if (compiled_) {
+        return;
+    }
+
+    // Collapse the alphabet to the bytes that appear in some pattern plus one
+    // shared class for everything else, so each DFA row stays small.
+    byteClass_.fill(0);
+    classCount_ = 1;
+    for (const auto& pattern : patterns_) {
+        for (unsigned char c : pattern) {
+            if (byteClass_[c] == 0) {
+                byteClass_[c] = static_cast<std::uint8_t>(classCount_++);
+            }
+        }
+    }
+
+    // Build the trie with unresolved edges
+    std::vector<std::int32_t> trie(classCount_, kNoState);
+    outputs_.assign(1, 0);
+    for (size_t index = 0; index < patterns_.size(); ++index) {
+        size_t state = 0;
+        for (unsigned char c : patterns_[index]) {
+            size_t edge = state * classCount_ + byteClass_[c];
+            if (trie[edge] == kNoState) {
+                trie[edge] = static_cast<std::int32_t>(outputs_.size());
+                outputs_.push_back(0);
+                trie.resize(trie.size() + classCount_, kNoState);
+            }
+            state = static_cast<size_t>(trie[edge]);
+        }
+        outputs_[state] |= Mask{ 1 } << index;
+    }
+
+    // Resolve failure links breadth-first into a complete transition table
+    const size_t stateCount = outputs_.size();
+    transitions_.assign(stateCount * classCount_, 0);
+    std::vector<std::uint32_t> fail(stateCount, 0);
+    std::deque<std::uint32_t> queue;
+
+    for (size_t cls = 0; cls < classCount_; ++cls) {
+        std::int32_t next = trie[cls];
+        if (next == kNoState) {
+            transitions_[cls] = 0;
+        } else {
+            transitions_[cls] = static_cast<std::uint32_t>(next);
+            fail[next] = 0;
+            queue.push_back(static_cast<std::uint32_t>(next));
+        }
+    }
+
+    while (!queue.empty()) {
+        std::uint32_t state = queue.front();
+        queue.pop_front();
+        outputs_[state] |= outputs_[fail[state]];
+
+        for (size_t cls = 0; cls < classCount_; ++cls) {
+            size_t edge = state * classCount_ + cls;
+            std::int32_t next = trie[edge];
+            std::uint32_t fallback = transitions_[fail[state] * classCount_ + cls];
+            if (next == kNoState) {
+                transitions_[edge] = fallback;
+            } else {
+                transitions_[edge] = static_cast<std::uint32_t>(next);
+                fail[next] = fallback;
+                queue.push_back(static_cast<std::uint32_t>(next));
+            }
+        }
+    }
+
+    // Most log bytes keep the automaton at the root; remember which bytes leave it
+    // so scan() can jump straight to candidate positions.
+    startByteCount_ = 0;
+    for (int c = 0; c < 256; ++c) {
+        startsPattern_[c] = transitions_[byteClass_[c]] != 0;
+        if (startsPattern_[c]) {
+            if (startByteCount_ < MAX_START_BYTES) {
+                startBytes_[startByteCount_] = static_cast<unsigned char>(c);
+            }
+            ++startByteCount_;
+        }
+    }
+    if (startByteCount_ > MAX_START_BYTES) {
+        startByteCount_ = 0;
+    } else {
+        for (size_t i = startByteCount_; i < MAX_START_BYTES; ++i) {
+            startBytes_[i] = startBytes_[0];
+        }
+    }
+
+    compiled_ = true;
+}
+
+KeywordMatcher::Mask KeywordMatcher::scan(std::string_view text) const noexcept {
+    if (!compiled_) {
+        return 0;
+    }
+
+    const std::uint32_t* transitions = transitions_.data();
+    const Mask* outputs = outputs_.data();
+    const size_t classCount = classCount_;
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+    const unsigned char* end = p + text.size();
+
+    Mask found = 0;
+    std::uint32_t state = 0;
+    while (p < end) {
+        if (state == 0) {
+            p = skipToStart(p, end);
+            if (p == end) {
+                break;
+            }
+        }
+        state = transitions[state * classCount + byteClass_[*p++]];
+        found |= outputs[state];
+    }
+    return found;
+}
+
+const unsigned char* KeywordMatcher::skipToStart(const unsigned char* p, const unsigned char* end) const noexcept {
+#ifdef AUTOFISHING_SSE2
+    if (startByteCount_ > 0) {
+        const __m128i b0 = _mm_set1_epi8(static_cast<char>(startBytes_[0]));
+        const __m128i b1 = _mm_set1_epi8(static_cast<char>(startBytes_[1]));
+        const __m128i b2 = _mm_set1_epi8(static_cast<char>(startBytes_[2]));
+        const __m128i b3 = _mm_set1_epi8(static_cast<char>(startBytes_[3]));
+        while (end - p >= 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i hits = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, b0), _mm_cmpeq_epi8(chunk, b1)),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, b2), _mm_cmpeq_epi8(chunk, b3)));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+            if (mask != 0) {
+                return p + lowestSetBit(mask);
+            }
+            p += 16;
+        }
+    }
+#endif
+    while (p < end && !startsPattern_[*p]) {
+        ++p;
+    }
+    return p;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Multi-keyword substring matcher (Aho-Corasick compiled into a DFA).
+// Register patterns up front, compile once, then each scan reports every
+// pattern that occurs in the text in a single pass over its bytes.
+class KeywordMatcher {
+public:
+    using Mask = std::uint64_t;
+    static constexpr size_t MAX_PATTERNS = 64;
+
+    // Returns the pattern index (bit position in scan masks), or -1 if the pattern
+    // is empty, the matcher is full or it has already been compiled.
+    int addPattern(std::string_view pattern);
+
+    void compile();
+    bool isCompiled() const noexcept { return compiled_; }
+    size_t patternCount() const noexcept { return patterns_.size(); }
+    const std::string& pattern(size_t index) const { return patterns_[index]; }
+
+    // Bit i is set when pattern i occurs anywhere in text
+    Mask scan(std::string_view text) const noexcept;
+
+private:
+    static constexpr size_t MAX_START_BYTES = 4;
+
+    // Advance to the next byte that can begin a pattern
+    const unsigned char* skipToStart(const unsigned char* p, const unsigned char* end) const noexcept;
+
+    std::vector<std::string> patterns_;
+    std::array<std::uint8_t, 256> byteClass_{};
+    size_t classCount_ = 1;
+    std::vector<std::uint32_t> transitions_;
+    std::vector<Mask> outputs_;
+    std::array<bool, 256> startsPattern_{};
+    std::array<unsigned char, MAX_START_BYTES> startBytes_{};
+    size_t startByteCount_ = 0;
+    bool compiled_ = false;
+};
@@ -0,0 +1,55 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+void LatencyHistogram::record(std::chrono::steady_clock::duration duration) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    uint64_t value = (std::min)(static_cast<uint64_t>((std::max)(micros, decltype(micros){ 0 })), kMaxMicros);
+    buckets_[bucketIndex(value)]++;
+    count_++;
+    totalMicros_ += value;
+    maxMicros_ = (std::max)(maxMicros_, value);
+}
+
+void LatencyHistogram::reset() {
+    *this = LatencyHistogram{};
+}
+
+double LatencyHistogram::meanMs() const {
+    return count_ ? static_cast<double>(totalMicros_) / count_ / 1000.0 : 0.0;
+}
+
+double LatencyHistogram::percentileMs(double p) const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 1.0) * count_));
+    rank = std::clamp<uint64_t>(rank, 1, count_);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return (std::min)(bucketMidpointMicros(i), static_cast<double>(maxMicros_)) / 1000.0;
+        }
+    }
+    return maxMs();
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t micros) {
+    if (micros < 2 * kSubBuckets) {
+        return static_cast<size_t>(micros);
+    }
+    // Keep the top kSubBucketBits + 1 bits; the rest only say where in the bucket it fell
+    unsigned shift = static_cast<unsigned>(std::bit_width(micros)) - 1 - kSubBucketBits;
+    return static_cast<size_t>(kSubBuckets * shift + (micros >> shift));
+}
+
+double LatencyHistogram::bucketMidpointMicros(size_t index) {
+    if (index < 2 * kSubBuckets) {
+        return static_cast<double>(index);
+    }
+    uint64_t shift = index / kSubBuckets - 1;
+    uint64_t top = index - kSubBuckets * shift;
+    return static_cast<double>(top << shift) + static_cast<double>(uint64_t{ 1 } << shift) / 2.0;
+}
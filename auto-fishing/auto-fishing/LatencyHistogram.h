@@ -0,0 +1,36 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Durations from a microsecond to about 19 hours in fixed log-linear buckets,
+// laid out like an HDR histogram: one bucket per microsecond below 64us, then
+// 32 buckets per power of two, so a reported percentile is within about 3% of
+// the true value. Recording is a few integer operations and never allocates.
+class LatencyHistogram {
+public:
+    void record(std::chrono::steady_clock::duration duration);
+    void reset();
+
+    uint64_t count() const { return count_; }
+    double meanMs() const;
+    double maxMs() const { return maxMicros_ / 1000.0; }
+    // Value at or below which fraction p (0 to 1) of the recordings fall; 0 when empty
+    double percentileMs(double p) const;
+
+private:
+    static constexpr unsigned kSubBucketBits = 5;
+    static constexpr uint64_t kSubBuckets = uint64_t{ 1 } << kSubBucketBits;
+    static constexpr size_t kBucketCount = 1024;
+    static constexpr uint64_t kMaxMicros = (uint64_t{ 1 } << 36) - 1;
+
+    static size_t bucketIndex(uint64_t micros);
+    // Midpoint of the range of durations the bucket holds
+    static double bucketMidpointMicros(size_t index);
+
+    std::array<uint64_t, kBucketCount> buckets_{};
+    uint64_t count_ = 0;
+    uint64_t totalMicros_ = 0;
+    uint64_t maxMicros_ = 0;
+};
@@ -0,0 +1,78 @@
+#include "LineSplitter.h"
+#include "SimdSupport.h"
+#include <cstring>
+
+namespace {
+
+const char* findNewlineScalar(const char* begin, const char* end) noexcept {
+    const void* hit = std::memchr(begin, '\n', static_cast<size_t>(end - begin));
+    return hit ? static_cast<const char*>(hit) : end;
+}
+
+#ifdef AUTOFISHING_SSE2
+const char* findNewlineSse2(const char* p, const char* end) noexcept {
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+        if (mask != 0) {
+            return p + lowestSetBit(mask);
+        }
+        p += 16;
+    }
+    return findNewlineScalar(p, end);
+}
+#endif
+
+#ifdef AUTOFISHING_AVX2
+AUTOFISHING_TARGET_AVX2
+const char* findNewlineAvx2(const char* p, const char* end) noexcept {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline)));
+        if (mask != 0) {
+            return p + lowestSetBit(mask);
+        }
+        p += 32;
+    }
+    return findNewlineSse2(p, end);
+}
+#endif
+
+FindNewlineFn selectFindNewline() noexcept {
+    if (FindNewlineFn avx2 = newlineKernel(NewlineKernel::Avx2)) {
+        return avx2;
+    }
+    if (FindNewlineFn sse2 = newlineKernel(NewlineKernel::Sse2)) {
+        return sse2;
+    }
+    return newlineKernel(NewlineKernel::Scalar);
+}
+
+} // namespace
+
+FindNewlineFn newlineKernel(NewlineKernel kernel) noexcept {
+    switch (kernel) {
+        case NewlineKernel::Scalar:
+            return &findNewlineScalar;
+        case NewlineKernel::Sse2:
+#ifdef AUTOFISHING_SSE2
+            return &findNewlineSse2;
+#else
+            return nullptr;
+#endif
+        case NewlineKernel::Avx2:
+#ifdef AUTOFISHING_AVX2
+            return cpuHasAvx2() ? &findNewlineAvx2 : nullptr;
+#else
+            return nullptr;
+#endif
+    }
+    return nullptr;
+}
+
+const char* findNewline(const char* begin, const char* end) noexcept {
+    static const FindNewlineFn impl = selectFindNewline();
+    return impl(begin, end);
+}
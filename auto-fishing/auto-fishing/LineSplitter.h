@@ -0,0 +1,33 @@
+#pragma once
+#include <string_view>
+
+// First '\n' in [begin, end), or end when there is none.
+// Uses AVX2 or SSE2 when available, memchr otherwise.
+const char* findNewline(const char* begin, const char* end) noexcept;
+
+// The kernels findNewline() picks from, for tools/linesplit_bench.cpp
+enum class NewlineKernel { Scalar, Sse2, Avx2 };
+using FindNewlineFn = const char* (*)(const char*, const char*) noexcept;
+
+// Null when the kernel is not compiled in or the CPU lacks it
+FindNewlineFn newlineKernel(NewlineKernel kernel) noexcept;
+
+// Calls fn(std::string_view line) for each non-empty line of text with the
+// "\n" or "\r\n" terminator stripped; a trailing unterminated line is included.
+// Views point into text. Return false from fn to stop early.
+template <typename Fn>
+void forEachLine(std::string_view text, Fn&& fn) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        const char* newline = findNewline(p, end);
+        const char* lineEnd = newline;
+        if (lineEnd > p && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        if (lineEnd > p && !fn(std::string_view(p, static_cast<size_t>(lineEnd - p)))) {
+            return;
+        }
+        p = (newline == end) ? end : newline + 1;
+    }
+}
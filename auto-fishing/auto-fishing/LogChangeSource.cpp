@@ -0,0 +1,246 @@
+#include "LogChangeSource.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+
+class WindowsLogChangeSource : public LogChangeSource {
+public:
+    WindowsLogChangeSource() {
+        stopEvent_ = CreateEventW(NULL, TRUE, FALSE, NULL);
+        overlapped_.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+    }
+
+    ~WindowsLogChangeSource() override {
+        if (directory_ != INVALID_HANDLE_VALUE) {
+            if (pending_) {
+                CancelIoEx(directory_, &overlapped_);
+                DWORD ignored = 0;
+                GetOverlappedResult(directory_, &overlapped_, &ignored, TRUE);
+            }
+            CloseHandle(directory_);
+        }
+        if (overlapped_.hEvent) {
+            CloseHandle(overlapped_.hEvent);
+        }
+        if (stopEvent_) {
+            CloseHandle(stopEvent_);
+        }
+    }
+
+    bool open(const std::filesystem::path& directory) override {
+        if (directory.empty() || !overlapped_.hEvent) {
+            return false;
+        }
+        directory_ = CreateFileW(
+            directory.c_str(),
+            FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL,
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+            NULL
+        );
+        if (directory_ == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        if (!arm()) {
+            CloseHandle(directory_);
+            directory_ = INVALID_HANDLE_VALUE;
+            return false;
+        }
+        return true;
+    }
+
+    LogChangeKind wait(std::chrono::milliseconds timeout) override {
+        if (!stopEvent_) {
+            return LogChangeKind::Stopped;
+        }
+        if (directory_ != INVALID_HANDLE_VALUE && !pending_) {
+            arm();
+        }
+
+        HANDLE handles[2] = { stopEvent_, overlapped_.hEvent };
+        DWORD handleCount = pending_ ? 2 : 1;
+        DWORD waitResult = WaitForMultipleObjects(handleCount, handles, FALSE, static_cast<DWORD>(timeout.count()));
+
+        if (waitResult == WAIT_OBJECT_0) {
+            return LogChangeKind::Stopped;
+        }
+        if (waitResult != WAIT_OBJECT_0 + 1) {
+            return LogChangeKind::None;
+        }
+
+        DWORD bytes = 0;
+        BOOL ok = GetOverlappedResult(directory_, &overlapped_, &bytes, FALSE);
+        pending_ = false;
+        LogChangeKind kind = LogChangeKind::Modified;
+        if (!ok || bytes == 0) {
+            // Notification buffer overflowed; the caller must rescan everything
+            kind = LogChangeKind::Created;
+        } else {
+            kind = parseNotifications(bytes);
+        }
+        arm();
+        return kind;
+    }
+
+    void interrupt() override {
+        if (stopEvent_) {
+            SetEvent(stopEvent_);
+        }
+    }
+
+    bool isWatching() const override {
+        return directory_ != INVALID_HANDLE_VALUE;
+    }
+
+private:
+    bool arm() {
+        ResetEvent(overlapped_.hEvent);
+        pending_ = ReadDirectoryChangesW(
+            directory_,
+            buffer_,
+            sizeof(buffer_),
+            FALSE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE,
+            NULL,
+            &overlapped_,
+            NULL
+        ) != FALSE;
+        return pending_;
+    }
+
+    LogChangeKind parseNotifications(DWORD bytes) const {
+        LogChangeKind kind = LogChangeKind::Modified;
+        DWORD offset = 0;
+        while (offset < bytes) {
+            auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(buffer_ + offset);
+            if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+                kind = LogChangeKind::Created;
+            }
+            if (info->NextEntryOffset == 0) {
+                break;
+            }
+            offset += info->NextEntryOffset;
+        }
+        return kind;
+    }
+
+    HANDLE directory_ = INVALID_HANDLE_VALUE;
+    HANDLE stopEvent_ = NULL;
+    OVERLAPPED overlapped_{};
+    bool pending_ = false;
+    alignas(DWORD) BYTE buffer_[16384];
+};
+
+#else
+
+class InotifyLogChangeSource : public LogChangeSource {
+public:
+    InotifyLogChangeSource() {
+        stopFd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    }
+
+    ~InotifyLogChangeSource() override {
+        if (inotifyFd_ >= 0) {
+            close(inotifyFd_);
+        }
+        if (stopFd_ >= 0) {
+            close(stopFd_);
+        }
+    }
+
+    bool open(const std::filesystem::path& directory) override {
+        if (directory.empty()) {
+            return false;
+        }
+        inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd_ < 0) {
+            return false;
+        }
+        if (inotify_add_watch(inotifyFd_, directory.c_str(), IN_MODIFY | IN_CREATE | IN_MOVED_TO) < 0) {
+            close(inotifyFd_);
+            inotifyFd_ = -1;
+            return false;
+        }
+        return true;
+    }
+
+    LogChangeKind wait(std::chrono::milliseconds timeout) override {
+        pollfd fds[2] = {
+            { stopFd_, POLLIN, 0 },
+            { inotifyFd_, POLLIN, 0 }
+        };
+        nfds_t count = inotifyFd_ >= 0 ? 2 : 1;
+        int result = poll(fds, count, static_cast<int>(timeout.count()));
+        if (result < 0) {
+            return errno == EINTR ? LogChangeKind::None : LogChangeKind::Stopped;
+        }
+        if (fds[0].revents & POLLIN) {
+            return LogChangeKind::Stopped;
+        }
+        if (result == 0 || count < 2 || !(fds[1].revents & POLLIN)) {
+            return LogChangeKind::None;
+        }
+        return drainEvents();
+    }
+
+    void interrupt() override {
+        if (stopFd_ >= 0) {
+            uint64_t one = 1;
+            (void)write(stopFd_, &one, sizeof(one));
+        }
+    }
+
+    bool isWatching() const override {
+        return inotifyFd_ >= 0;
+    }
+
+private:
+    LogChangeKind drainEvents() {
+        LogChangeKind kind = LogChangeKind::None;
+        alignas(inotify_event) char buffer[4096];
+        for (;;) {
+            ssize_t length = read(inotifyFd_, buffer, sizeof(buffer));
+            if (length <= 0) {
+                break;
+            }
+            for (ssize_t offset = 0; offset < length;) {
+                auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                if (event->mask & (IN_CREATE | IN_MOVED_TO | IN_Q_OVERFLOW)) {
+                    kind = LogChangeKind::Created;
+                } else if ((event->mask & IN_MODIFY) && kind == LogChangeKind::None) {
+                    kind = LogChangeKind::Modified;
+                }
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            }
+        }
+        return kind;
+    }
+
+    int inotifyFd_ = -1;
+    int stopFd_ = -1;
+};
+
+#endif
+
+} // namespace
+
+std::unique_ptr<LogChangeSource> LogChangeSource::create() {
+#ifdef _WIN32
+    return std::make_unique<WindowsLogChangeSource>();
+#else
+    return std::make_unique<InotifyLogChangeSource>();
+#endif
+}
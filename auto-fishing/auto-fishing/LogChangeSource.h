@@ -0,0 +1,32 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <memory>
+
+// What a LogChangeSource observed while waiting
+enum class LogChangeKind {
+    None,       // Timed out without a notification
+    Modified,   // A file in the directory was written to
+    Created,    // A file appeared (new session log) or the change queue overflowed
+    Stopped     // interrupt() was called
+};
+
+// Change-notification backend for the VRChat log directory.
+// ReadDirectoryChangesW on Windows, inotify on Linux.
+class LogChangeSource {
+public:
+    virtual ~LogChangeSource() = default;
+
+    // Start watching a directory. On failure wait() degrades to an interruptible sleep.
+    virtual bool open(const std::filesystem::path& directory) = 0;
+
+    // Block until a change is reported, the timeout expires or interrupt() is called
+    virtual LogChangeKind wait(std::chrono::milliseconds timeout) = 0;
+
+    // Wake every current and future wait() with Stopped
+    virtual void interrupt() = 0;
+
+    virtual bool isWatching() const = 0;
+
+    static std::unique_ptr<LogChangeSource> create();
+};
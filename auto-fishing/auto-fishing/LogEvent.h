@@ -0,0 +1,42 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+enum class LogEventType {
+    FishOnHook,
+    FishPickup,
+    BucketSave
+};
+
+constexpr LogEventType kLogEventTypes[] = {
+    LogEventType::FishOnHook,
+    LogEventType::FishPickup,
+    LogEventType::BucketSave
+};
+
+constexpr size_t kLogEventTypeCount = sizeof(kLogEventTypes) / sizeof(kLogEventTypes[0]);
+
+// Names used in config.json
+constexpr const char* kLogEventTypeNames[kLogEventTypeCount] = { "FishOnHook", "FishPickup", "BucketSave" };
+
+// Log text that marks each event type
+constexpr const char* kFishHookKeyword = "SAVED DATA";
+constexpr const char* kFishPickupKeyword = "Fish Pickup attached to rod Toggles(True)";
+constexpr const char* kBucketSaveKeyword = "Attempt saving";
+
+// One keyword line, parsed once at ingestion, or an OSC message bound to an
+// event type (see OscEventDispatcher)
+struct LogEvent {
+    LogEventType type;
+    // Wall-clock time printed on the line, if it had one; when an OSC message arrived
+    std::optional<std::chrono::system_clock::time_point> timestamp;
+    // When the reader ingested the line
+    std::chrono::steady_clock::time_point observedAt;
+    // Byte offset of the line start within the log file; 0 for OSC messages
+    uint64_t fileOffset;
+    // Line text without terminator, or the OSC address; only valid for the duration of the callback
+    std::string_view body;
+};
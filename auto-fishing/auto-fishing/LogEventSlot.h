@@ -0,0 +1,29 @@
+#pragma once
+#include "FishingConfig.h"
+#include "LogEvent.h"
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+// Queue slot for a LogEvent and the line its body points into. The line is
+// copied into storage the slot keeps for its whole life, so passing an event
+// between threads never allocates. Lines longer than LOG_EVENT_BODY_BYTES are
+// cut short; only the body is affected, as the event was parsed from the full line.
+struct LogEventSlot {
+    LogEvent event{};
+    size_t lineSize = 0;
+    std::array<char, FishingConfig::LOG_EVENT_BODY_BYTES> line;
+
+    void assign(const LogEvent& source, std::string_view text) noexcept {
+        event = source;
+        lineSize = text.size() < line.size() ? text.size() : line.size();
+        std::memcpy(line.data(), text.data(), lineSize);
+    }
+
+    // The event with its body pointing into this slot
+    const LogEvent& view() noexcept {
+        event.body = std::string_view(line.data(), lineSize);
+        return event;
+    }
+};
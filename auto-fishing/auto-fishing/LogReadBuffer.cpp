@@ -0,0 +1,59 @@
+#include "LogReadBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+LogReadBuffer::LogReadBuffer(size_t initialCapacity)
+    : storage_(new char[initialCapacity > 0 ? initialCapacity : 1])
+    , capacity_(initialCapacity > 0 ? initialCapacity : 1)
+{
+}
+
+char* LogReadBuffer::prepare(size_t minBytes) {
+    if (capacity_ - end_ >= minBytes) {
+        return storage_.get() + end_;
+    }
+
+    // Move the carried-over partial line to the front before considering growth
+    const size_t buffered = size();
+    if (begin_ > 0) {
+        std::memmove(storage_.get(), storage_.get() + begin_, buffered);
+        begin_ = 0;
+        end_ = buffered;
+    }
+
+    if (capacity_ - end_ < minBytes) {
+        size_t newCapacity = (std::max)(capacity_ * 2, buffered + minBytes);
+        std::unique_ptr<char[]> grown(new char[newCapacity]);
+        std::memcpy(grown.get(), storage_.get(), buffered);
+        storage_ = std::move(grown);
+        capacity_ = newCapacity;
+    }
+    return storage_.get() + end_;
+}
+
+void LogReadBuffer::commit(size_t bytes) noexcept {
+    end_ = (std::min)(end_ + bytes, capacity_);
+}
+
+std::string_view LogReadBuffer::completeLines() const noexcept {
+    const char* data = storage_.get() + begin_;
+    for (size_t i = size(); i > 0; --i) {
+        if (data[i - 1] == '\n') {
+            return std::string_view(data, i);
+        }
+    }
+    return std::string_view();
+}
+
+void LogReadBuffer::consume(size_t bytes) noexcept {
+    begin_ += (std::min)(bytes, size());
+    if (begin_ == end_) {
+        begin_ = 0;
+        end_ = 0;
+    }
+}
+
+void LogReadBuffer::clear() noexcept {
+    begin_ = 0;
+    end_ = 0;
+}
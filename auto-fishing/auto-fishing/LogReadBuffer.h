@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+// Reusable buffer for incremental log reads. New bytes are appended directly
+// after the partial line carried over from the previous read, complete lines
+// are handed out as a view, and the buffer only grows when a single read plus
+// carry-over exceeds its capacity.
+class LogReadBuffer {
+public:
+    explicit LogReadBuffer(size_t initialCapacity = 64 * 1024);
+
+    LogReadBuffer(const LogReadBuffer&) = delete;
+    LogReadBuffer& operator=(const LogReadBuffer&) = delete;
+
+    // Writable space for at least minBytes after the buffered data
+    char* prepare(size_t minBytes);
+    void commit(size_t bytes) noexcept;
+
+    // Buffered bytes up to and including the last '\n'; valid until the next prepare()
+    std::string_view completeLines() const noexcept;
+    void consume(size_t bytes) noexcept;
+
+    void clear() noexcept;
+    size_t size() const noexcept { return end_ - begin_; }
+    size_t capacity() const noexcept { return capacity_; }
+
+private:
+    std::unique_ptr<char[]> storage_;
+    size_t capacity_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+};
@@ -0,0 +1,161 @@
+#include "LogTimestamp.h"
+#include <cstdint>
+#include <ctime>
+
+namespace {
+
+// "YYYY.MM.DD HH:MM:SS"
+constexpr size_t kTimestampLength = 19;
+
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline int twoDigits(const char* p) {
+    return (p[0] - '0') * 10 + (p[1] - '0');
+}
+
+bool matchesTimestampAt(const char* p) {
+    return p[4] == '.' && p[7] == '.' && p[10] == ' ' && p[13] == ':' && p[16] == ':'
+        && isDigit(p[0]) && isDigit(p[1]) && isDigit(p[2]) && isDigit(p[3])
+        && isDigit(p[5]) && isDigit(p[6]) && isDigit(p[8]) && isDigit(p[9])
+        && isDigit(p[11]) && isDigit(p[12]) && isDigit(p[14]) && isDigit(p[15])
+        && isDigit(p[17]) && isDigit(p[18]);
+}
+
+// Converting local time does a time-zone lookup, so it runs once per local
+// hour. Minutes and seconds are added to the cached hour start unless a DST
+// transition falls inside that hour, in which case every line pays for the
+// full conversion.
+struct HourEpochCache {
+    int64_t key = -1;
+    std::time_t hourStart = 0;
+    bool uniform = false;
+};
+
+int64_t floorDiv(int64_t value, int64_t divisor) {
+    return value / divisor - ((value % divisor != 0) && ((value < 0) != (divisor < 0)));
+}
+
+// Seconds since the epoch of a date and time read as UTC. Fields out of range
+// carry over, as with mktime.
+int64_t civilSeconds(int64_t year, int64_t month, int64_t day, int64_t hour, int64_t minute, int64_t second) {
+    year += floorDiv(month - 1, 12);
+    month -= floorDiv(month - 1, 12) * 12;
+    // Days from 1970-01-01 to year-month-01 (proleptic Gregorian, March-based years)
+    const int64_t y = month <= 2 ? year - 1 : year;
+    const int64_t era = floorDiv(y, 400);
+    const int64_t yearOfEra = y - era * 400;
+    const int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5;
+    const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    const int64_t days = era * 146097 + dayOfEra - 719468 + (day - 1);
+    return ((days * 24 + hour) * 60 + minute) * 60 + second;
+}
+
+// Local clock minus UTC at t, in seconds
+bool utcOffsetAt(std::time_t t, int64_t& offset) {
+    std::tm local{};
+#ifdef _WIN32
+    if (localtime_s(&local, &t) != 0) {
+        return false;
+    }
+#else
+    if (!localtime_r(&t, &local)) {
+        return false;
+    }
+#endif
+    offset = civilSeconds(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+                          local.tm_hour, local.tm_min, local.tm_sec) - t;
+    return true;
+}
+
+// mktime() with tm_isdst = -1 resolves a local time the clock shows twice by
+// whichever offset its previous call used, so the answer depended on what was
+// parsed before. This picks the same instant every time: the first of the two
+// for a repeated time, and for a time skipped by the clock, the one read with
+// the offset in force before the change (02:30 in a skipped hour is 03:30).
+std::time_t localToEpoch(int year, int month, int day, int hour, int minute, int second) {
+    const int64_t local = civilSeconds(year, month, day, hour, minute, second);
+    // Transitions are months apart, so the offsets a day either side are the
+    // only two that can apply
+    int64_t before = 0;
+    int64_t after = 0;
+    if (!utcOffsetAt(static_cast<std::time_t>(local - 86400), before)
+        || !utcOffsetAt(static_cast<std::time_t>(local + 86400), after)) {
+        return static_cast<std::time_t>(-1);
+    }
+    const std::time_t readBefore = static_cast<std::time_t>(local - before);
+    const std::time_t readAfter = static_cast<std::time_t>(local - after);
+    int64_t offset = 0;
+    const bool beforeValid = utcOffsetAt(readBefore, offset) && offset == before;
+    const bool afterValid = utcOffsetAt(readAfter, offset) && offset == after;
+    if (beforeValid && afterValid) {
+        return readBefore < readAfter ? readBefore : readAfter;
+    }
+    return afterValid ? readAfter : readBefore;
+}
+
+// True when the local clock reads exactly hour + 1 one hour after hourStart
+bool isUniformHour(std::time_t hourStart, int hour) {
+    std::time_t next = hourStart + 3600;
+    std::tm local{};
+#ifdef _WIN32
+    if (localtime_s(&local, &next) != 0) {
+        return false;
+    }
+#else
+    if (!localtime_r(&next, &local)) {
+        return false;
+    }
+#endif
+    return local.tm_hour == (hour + 1) % 24 && local.tm_min == 0 && local.tm_sec == 0;
+}
+
+thread_local HourEpochCache tlsHourCache;
+
+} // namespace
+
+std::optional<std::chrono::system_clock::time_point> parseLogTimestamp(std::string_view line) {
+    if (line.size() < kTimestampLength) {
+        return std::nullopt;
+    }
+
+    // VRChat puts the timestamp at the start of the line; fall back to the
+    // leftmost match anywhere, like the old regex_search.
+    const char* begin = line.data();
+    const char* last = begin + (line.size() - kTimestampLength);
+    const char* p = begin;
+    while (p <= last && !matchesTimestampAt(p)) {
+        ++p;
+    }
+    if (p > last) {
+        return std::nullopt;
+    }
+
+    const int year = twoDigits(p) * 100 + twoDigits(p + 2);
+    const int month = twoDigits(p + 5);
+    const int day = twoDigits(p + 8);
+    const int hour = twoDigits(p + 11);
+    const int minute = twoDigits(p + 14);
+    const int second = twoDigits(p + 17);
+
+    const int64_t key = ((static_cast<int64_t>(year) * 100 + month) * 100 + day) * 100 + hour;
+    HourEpochCache& cache = tlsHourCache;
+    if (cache.key != key) {
+        std::time_t hourStart = localToEpoch(year, month, day, hour, 0, 0);
+        if (hourStart == static_cast<std::time_t>(-1)) {
+            return std::nullopt;
+        }
+        cache.key = key;
+        cache.hourStart = hourStart;
+        cache.uniform = isUniformHour(hourStart, hour);
+    }
+
+    std::time_t epoch = cache.uniform
+        ? cache.hourStart + minute * 60 + second
+        : localToEpoch(year, month, day, hour, minute, second);
+    if (epoch == static_cast<std::time_t>(-1)) {
+        return std::nullopt;
+    }
+    return std::chrono::system_clock::from_time_t(epoch);
+}
@@ -0,0 +1,7 @@
+#pragma once
+#include <chrono>
+#include <optional>
+#include <string_view>
+
+// Wall-clock time of a VRChat log line ("YYYY.MM.DD HH:MM:SS", local time)
+std::optional<std::chrono::system_clock::time_point> parseLogTimestamp(std::string_view line);
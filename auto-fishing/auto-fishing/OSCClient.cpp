@@ -1,30 +1,29 @@
 #include "OSCClient.h"
-#include <cstring>
 #include <iostream>
 
-OSCClient::OSCClient(const std::string& ip, int port) : sock(INVALID_SOCKET), initialized(false) {
-    // Initialize Winsock
-    WSADATA wsaData;
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
-        std::cerr << "WSAStartup failed" << std::endl;
-        return;
-    }
+namespace {
+constexpr const char* kClickAddress = "/input/UseRight";
+}
 
-    // Create UDP socket
-    sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (sock == INVALID_SOCKET) {
-        std::cerr << "Socket creation failed" << std::endl;
-        WSACleanup();
+OSCClient::OSCClient(const std::string& ip, int port)
+    : OSCClient(std::vector<OscTarget>{ OscTarget{ ip, port } }) {
+}
+
+OSCClient::OSCClient(const std::vector<OscTarget>& targets) : initialized(false) {
+    // Clicks are the only messages sent while fishing
+    pressMessage_ = internMessage(kClickAddress, 1);
+    releaseMessage_ = internMessage(kClickAddress, 0);
+
+    if (!transport_.isOpen()) {
         return;
     }
+    for (const OscTarget& target : targets) {
+        if (transport_.addTarget(target.host, target.port) == OscTransport::INVALID_TARGET) {
+            std::cerr << "Invalid OSC target " << target.host << ":" << target.port << std::endl;
+        }
+    }
 
-    // Set server address
-    memset(&serverAddr, 0, sizeof(serverAddr));
-    serverAddr.sin_family = AF_INET;
-    serverAddr.sin_port = htons(port);
-    inet_pton(AF_INET, ip.c_str(), &serverAddr.sin_addr);
-
-    initialized = true;
+    initialized = transport_.targetCount() > 0;
 }
 
 OSCClient::~OSCClient() {
@@ -35,57 +34,55 @@ bool OSCClient::initialize() {
     return initialized;
 }
 
-size_t OSCClient::padTo4Bytes(size_t size) {
-    return (size + 3) & ~3;
+bool OSCClient::sendMessage(const std::string& address, int value) {
+    return send(address, static_cast<int32_t>(value));
 }
 
-std::string OSCClient::buildOSCMessage(const std::string& address, int value) {
-    std::string message;
-
-    // OSC Address
-    message += address;
-    // Pad to 4-byte boundary
-    size_t addressPadded = padTo4Bytes(address.length() + 1);
-    message.append(addressPadded - address.length(), '\0');
-
-    // Type tag string ",i" for an integer argument
-    message += ",i";
-    // Pad to 4-byte boundary
-    message.append(2, '\0');
-
-    // Integer value (big-endian)
-    unsigned char valueBytes[4];
-    valueBytes[0] = (value >> 24) & 0xFF;
-    valueBytes[1] = (value >> 16) & 0xFF;
-    valueBytes[2] = (value >> 8) & 0xFF;
-    valueBytes[3] = value & 0xFF;
-    message.append(reinterpret_cast<char*>(valueBytes), 4);
-
-    return message;
+bool OSCClient::send(const OscWriter& writer) {
+    if (!initialized) {
+        return false;
+    }
+    if (!writer.complete()) {
+        std::cerr << "OSC packet incomplete or too long" << std::endl;
+        return false;
+    }
+    return sendBytes(writer.data(), writer.size());
 }
 
-bool OSCClient::sendMessage(const std::string& address, int value) {
-    if (!initialized) {
+bool OSCClient::sendInterned(MessageId id) {
+    if (!initialized || id >= internedCount_) {
         return false;
     }
+    const OscPacket& packet = interned_[id];
+    return sendBytes(packet.data(), packet.size());
+}
 
-    std::string message = buildOSCMessage(address, value);
-    
-    int result = sendto(sock, message.c_str(), static_cast<int>(message.length()), 
-                       0, (sockaddr*)&serverAddr, sizeof(serverAddr));
-    
-    return result != SOCKET_ERROR;
+bool OSCClient::sendBytes(const char* data, size_t size) {
+    return transport_.send(data, size);
 }
 
 bool OSCClient::sendClick(bool press) {
-    return sendMessage("/input/UseRight", press ? 1 : 0);
+    return sendInterned(press ? pressMessage_ : releaseMessage_);
+}
+
+bool OSCClient::sendTimedClick(std::chrono::system_clock::time_point pressAt,
+                               std::chrono::system_clock::time_point releaseAt) {
+    std::array<char, 128> buffer;
+    OscWriter writer(buffer);
+    writer.beginBundle(oscTimeTag(pressAt));
+    writer.message(kClickAddress, 1);
+    writer.beginBundle(oscTimeTag(releaseAt));
+    writer.message(kClickAddress, 0);
+    writer.endBundle();
+    writer.endBundle();
+    return send(writer);
+}
+
+std::vector<OscTargetStats> OSCClient::getTargetStats() const {
+    return transport_.getStats();
 }
 
 void OSCClient::cleanup() {
-    if (sock != INVALID_SOCKET) {
-        closesocket(sock);
-        sock = INVALID_SOCKET;
-    }
-    WSACleanup();
+    // The transport closes its socket when the client is destroyed
     initialized = false;
 }
\ No newline at end of file
@@ -1,24 +1,41 @@
 #pragma once
+#include "OscPacket.h"
+#include "OscSink.h"
+#include "OscTransport.h"
+#include "OscWriter.h"
+#include <array>
+#include <cstddef>
+#include <optional>
 #include <string>
-#include <winsock2.h>
-#include <ws2tcpip.h>
-#pragma comment(lib, "ws2_32.lib")
+#include <string_view>
+#include <vector>
+
+// OSC Client Class - for sending OSC messages to VRChat; every message goes
+// to each of its targets
+class OSCClient : public OscSink {
+public:
+    using MessageId = size_t;
+    static constexpr MessageId INVALID_MESSAGE = static_cast<MessageId>(-1);
+    static constexpr size_t MAX_INTERNED_MESSAGES = 16;
+    // Stack buffer send() encodes into
+    static constexpr size_t MAX_MESSAGE_BYTES = 1024;
 
-// OSC Client Class - for sending OSC messages to VRChat
-class OSCClient {
 private:
-    SOCKET sock;
-    sockaddr_in serverAddr;
+    OscTransport transport_;
     bool initialized;
 
-    // Build OSC message
-    std::string buildOSCMessage(const std::string& address, int value);
-    
-    // Pad to 4-byte boundary
-    size_t padTo4Bytes(size_t size);
+    // Encoded once, then sent as-is; entries are never changed after interning
+    std::array<OscPacket, MAX_INTERNED_MESSAGES> interned_;
+    size_t internedCount_ = 0;
+    MessageId pressMessage_ = INVALID_MESSAGE;
+    MessageId releaseMessage_ = INVALID_MESSAGE;
+
+    bool sendBytes(const char* data, size_t size);
 
 public:
     OSCClient(const std::string& ip = "127.0.0.1", int port = 9000);
+    // One VRChat client per target, e.g. several on one machine with their own ports
+    explicit OSCClient(const std::vector<OscTarget>& targets);
     ~OSCClient();
 
     // Initialize socket
@@ -27,9 +44,49 @@ public:
     // Send message
     bool sendMessage(const std::string& address, int value);
 
+    // Encodes a message with any OscWriter arguments on the stack and sends it
+    template <typename... Args>
+    bool send(std::string_view address, const Args&... args);
+    // Sends a packet the caller wrote, e.g. a bundle; false unless it is complete
+    bool send(const OscWriter& writer);
+
+    // Encodes the message once for sendInterned(); call before other threads send.
+    // INVALID_MESSAGE if the table is full or the message is too long.
+    template <typename... Args>
+    MessageId internMessage(std::string_view address, const Args&... args);
+    // Sends an interned message with no allocation or encoding
+    bool sendInterned(MessageId id);
+
     // Send click message
-    bool sendClick(bool press);
+    bool sendClick(bool press) override;
+    // One bundle tagged pressAt holding the press and a nested bundle tagged releaseAt holding the release
+    bool sendTimedClick(std::chrono::system_clock::time_point pressAt,
+                        std::chrono::system_clock::time_point releaseAt) override;
+
+    // Packets, bytes and errors per target, in the order they were given
+    std::vector<OscTargetStats> getTargetStats() const;
 
     // Cleanup resources
     void cleanup();
-};
\ No newline at end of file
+};
+
+template <typename... Args>
+bool OSCClient::send(std::string_view address, const Args&... args) {
+    std::array<char, MAX_MESSAGE_BYTES> buffer;
+    OscWriter writer(buffer);
+    writer.message(address, args...);
+    return send(writer);
+}
+
+template <typename... Args>
+OSCClient::MessageId OSCClient::internMessage(std::string_view address, const Args&... args) {
+    if (internedCount_ >= interned_.size()) {
+        return INVALID_MESSAGE;
+    }
+    std::optional<OscPacket> packet = OscPacket::message(address, args...);
+    if (!packet) {
+        return INVALID_MESSAGE;
+    }
+    interned_[internedCount_] = *packet;
+    return internedCount_++;
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "OSCServer.h"
+#include <cstring>
+#include <iostream>
+
+OSCServer::OSCServer(FishingClock& clock, OscEventDispatcher::EventCallback callback,
+                     const std::string& ip, int port)
+    : clock_(clock)
+    , dispatcher_(std::move(callback))
+    , ip_(ip)
+    , port_(port)
+    , sock_(INVALID_SOCKET)
+    , winsockStarted_(false)
+    , packet_(new char[MAX_PACKET_BYTES])
+    , running_(false)
+    , packets_(0)
+    , messages_(0)
+    , events_(0)
+    , malformed_(0)
+{
+}
+
+OSCServer::~OSCServer() {
+    stop();
+}
+
+bool OSCServer::addBinding(std::string_view address, LogEventType type) {
+    if (isRunning()) {
+        return false;
+    }
+    return dispatcher_.addBinding(address, type);
+}
+
+bool OSCServer::start() {
+    if (isRunning()) {
+        return true;
+    }
+
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "WSAStartup failed" << std::endl;
+        return false;
+    }
+    winsockStarted_ = true;
+
+    sock_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock_ == INVALID_SOCKET) {
+        std::cerr << "Socket creation failed" << std::endl;
+        stop();
+        return false;
+    }
+
+    sockaddr_in localAddr;
+    memset(&localAddr, 0, sizeof(localAddr));
+    localAddr.sin_family = AF_INET;
+    localAddr.sin_port = htons(static_cast<unsigned short>(port_));
+    inet_pton(AF_INET, ip_.c_str(), &localAddr.sin_addr);
+    // Non-blocking, so a drain ends as soon as the queue is empty
+    u_long nonBlocking = 1;
+    if (bind(sock_, (sockaddr*)&localAddr, sizeof(localAddr)) == SOCKET_ERROR
+        || ioctlsocket(sock_, FIONBIO, &nonBlocking) == SOCKET_ERROR) {
+        std::cerr << "OSC listen port " << port_ << " unavailable: " << WSAGetLastError() << std::endl;
+        stop();
+        return false;
+    }
+
+    running_.store(true, std::memory_order_release);
+    receiveThread_ = std::thread(&OSCServer::receiveThread, this);
+    return true;
+}
+
+void OSCServer::stop() {
+    running_.store(false, std::memory_order_release);
+    if (receiveThread_.joinable()) {
+        receiveThread_.join();
+    }
+    if (sock_ != INVALID_SOCKET) {
+        closesocket(sock_);
+        sock_ = INVALID_SOCKET;
+    }
+    if (winsockStarted_) {
+        WSACleanup();
+        winsockStarted_ = false;
+    }
+}
+
+OscServerStats OSCServer::getStats() const {
+    OscServerStats stats{};
+    stats.packets = packets_.load(std::memory_order_relaxed);
+    stats.messages = messages_.load(std::memory_order_relaxed);
+    stats.events = events_.load(std::memory_order_relaxed);
+    stats.malformed = malformed_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void OSCServer::receiveThread() {
+    // select() returns as soon as a datagram arrives; the timeout only bounds
+    // how long stop() waits for this thread
+    const long pollMicros = static_cast<long>(FishingConfig::OSC_RECEIVE_POLL_INTERVAL * 1000000.0);
+    while (running_.load(std::memory_order_acquire)) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(sock_, &readable);
+        timeval timeout{ pollMicros / 1000000, pollMicros % 1000000 };
+        int ready = select(0, &readable, nullptr, nullptr, &timeout);
+        if (ready == SOCKET_ERROR) {
+            std::cerr << "OSC receive failed: " << WSAGetLastError() << std::endl;
+            return;
+        }
+        if (ready > 0) {
+            drainSocket();
+        }
+    }
+}
+
+void OSCServer::drainSocket() {
+    while (running_.load(std::memory_order_acquire)) {
+        int received = recvfrom(sock_, packet_.get(), static_cast<int>(MAX_PACKET_BYTES), 0, nullptr, nullptr);
+        if (received == SOCKET_ERROR) {
+            // WSAEWOULDBLOCK: drained. WSAECONNRESET: an ICMP error for an
+            // earlier datagram, nothing to do with this socket's input.
+            // WSAEMSGSIZE: a datagram too large for the buffer, dropped.
+            int error = WSAGetLastError();
+            if (error == WSAECONNRESET || error == WSAEMSGSIZE) {
+                continue;
+            }
+            return;
+        }
+
+        OscDispatchResult result = dispatcher_.dispatch(packet_.get(), static_cast<size_t>(received),
+                                                        clock_.now(), clock_.wallNow());
+        packets_.fetch_add(1, std::memory_order_relaxed);
+        messages_.fetch_add(result.messages, std::memory_order_relaxed);
+        events_.fetch_add(result.events, std::memory_order_relaxed);
+        if (result.malformed) {
+            malformed_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
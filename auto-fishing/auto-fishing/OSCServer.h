@@ -0,0 +1,66 @@
+#pragma once
+#include "FishingClock.h"
+#include "FishingConfig.h"
+#include "OscEventDispatcher.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+
+struct OscServerStats {
+    uint64_t packets;
+    uint64_t messages;
+    uint64_t events;
+    uint64_t malformed;
+};
+
+// OSC Server Class - for receiving what VRChat sends (avatar parameters on
+// port 9001) and raising the bound cycle events; the counterpart of OSCClient
+class OSCServer {
+public:
+    // Largest UDP payload
+    static constexpr size_t MAX_PACKET_BYTES = 65507;
+
+    // Events go to callback on the receive thread; observedAt is read from clock
+    OSCServer(FishingClock& clock, OscEventDispatcher::EventCallback callback,
+              const std::string& ip = "127.0.0.1", int port = FishingConfig::DEFAULT_OSC_LISTEN_PORT);
+    ~OSCServer();
+
+    OSCServer(const OSCServer&) = delete;
+    OSCServer& operator=(const OSCServer&) = delete;
+
+    // Only valid before start()
+    bool addBinding(std::string_view address, LogEventType type);
+
+    // Binds the port and starts the receive thread; false if the port is taken
+    bool start();
+    void stop();
+
+    OscServerStats getStats() const;
+    bool isRunning() const noexcept { return running_.load(std::memory_order_acquire); }
+
+private:
+    void receiveThread();
+    // Reads every datagram already queued on the socket
+    void drainSocket();
+
+    FishingClock& clock_;
+    OscEventDispatcher dispatcher_;
+    std::string ip_;
+    int port_;
+    SOCKET sock_;
+    bool winsockStarted_;
+    std::unique_ptr<char[]> packet_;
+
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> packets_;
+    std::atomic<uint64_t> messages_;
+    std::atomic<uint64_t> events_;
+    std::atomic<uint64_t> malformed_;
+    std::thread receiveThread_;
+};
@@ -0,0 +1,49 @@
+#include "OscEventDispatcher.h"
+#include "OscReader.h"
+
+OscEventDispatcher::OscEventDispatcher(EventCallback callback)
+    : callback_(std::move(callback))
+{
+}
+
+bool OscEventDispatcher::addBinding(std::string_view address, LogEventType type) {
+    if (address.empty() || address.front() != '/') {
+        return false;
+    }
+    BindingState state;
+    state.binding.address = std::string(address);
+    state.binding.type = type;
+    bindings_.push_back(std::move(state));
+    return true;
+}
+
+OscDispatchResult OscEventDispatcher::dispatch(const char* data, size_t size,
+                                               std::chrono::steady_clock::time_point observedAt,
+                                               std::chrono::system_clock::time_point arrivedAt) {
+    OscDispatchResult result;
+    bool wellFormed = oscForEachMessage(data, size, [&](const OscMessageView& message) {
+        result.messages++;
+        bool on = message.argumentCount() == 0 || message.argument(0).truthy();
+        for (BindingState& state : bindings_) {
+            if (!oscPatternMatches(message.address(), state.binding.address)) {
+                continue;
+            }
+            bool turnedOn = on && (!state.on || message.argumentCount() == 0);
+            state.on = on;
+            if (!turnedOn) {
+                continue;
+            }
+
+            LogEvent event{};
+            event.type = state.binding.type;
+            event.timestamp = arrivedAt;
+            event.observedAt = observedAt;
+            event.fileOffset = 0;
+            event.body = message.address();
+            result.events++;
+            callback_(event);
+        }
+    });
+    result.malformed = !wellFormed;
+    return result;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "LogEvent.h"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// An OSC address that raises a cycle event, e.g. an avatar parameter a world
+// sets when a fish bites
+struct OscBinding {
+    std::string address;
+    LogEventType type;
+};
+
+struct OscDispatchResult {
+    size_t messages = 0;
+    size_t events = 0;
+    bool malformed = false;
+};
+
+// Turns received OSC packets into the LogEvents VRChatLogHandler reads from
+// log lines, so the cycle hears of a bite as soon as VRChat sends the
+// parameter instead of after the log is flushed and polled.
+//
+// A binding raises its event when a message to its address turns on: a true
+// bool or a nonzero number after a false or zero one (VRChat resends
+// parameters that did not change), or any message without arguments. The
+// incoming address is matched as an OSC address pattern against each bound
+// address. Used from one thread at a time.
+class OscEventDispatcher {
+public:
+    using EventCallback = std::function<void(const LogEvent&)>;
+
+    explicit OscEventDispatcher(EventCallback callback);
+
+    // False if address is not an OSC address ("/..."); only valid before the first dispatch()
+    bool addBinding(std::string_view address, LogEventType type);
+    size_t bindingCount() const { return bindings_.size(); }
+
+    // Parses the packet in place and runs the callback for every event it raises
+    OscDispatchResult dispatch(const char* data, size_t size,
+                               std::chrono::steady_clock::time_point observedAt,
+                               std::chrono::system_clock::time_point arrivedAt);
+
+private:
+    struct BindingState {
+        OscBinding binding;
+        bool on = false;
+    };
+
+    EventCallback callback_;
+    std::vector<BindingState> bindings_;
+};
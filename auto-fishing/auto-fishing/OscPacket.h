@@ -0,0 +1,32 @@
+#pragma once
+#include "OscWriter.h"
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+// One OSC message, encoded once into a fixed aligned buffer so it can be sent
+// any number of times with no allocation or formatting.
+class OscPacket {
+public:
+    static constexpr size_t kCapacity = 64;
+
+    // nullopt if the message does not fit in kCapacity
+    template <typename... Args>
+    static std::optional<OscPacket> message(std::string_view address, const Args&... args) {
+        OscPacket packet;
+        OscWriter writer(packet.bytes_);
+        if (!writer.message(address, args...)) {
+            return std::nullopt;
+        }
+        packet.size_ = writer.size();
+        return packet;
+    }
+
+    const char* data() const { return bytes_.data(); }
+    size_t size() const { return size_; }
+
+private:
+    alignas(16) std::array<char, kCapacity> bytes_{};
+    size_t size_ = 0;
+};
@@ -0,0 +1,309 @@
+#include "OscReader.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <vector>
+
+namespace {
+
+// Reads the padded string at offset; false unless it is terminated within size
+bool readString(const char* data, size_t size, size_t& offset, std::string_view& text) {
+    if (offset >= size) {
+        return false;
+    }
+    const void* terminator = std::memchr(data + offset, '\0', size - offset);
+    if (!terminator) {
+        return false;
+    }
+    size_t length = static_cast<const char*>(terminator) - (data + offset);
+    size_t padded = oscStringSize(length);
+    if (padded > size - offset) {
+        return false;
+    }
+    text = std::string_view(data + offset, length);
+    offset += padded;
+    return true;
+}
+
+// Reads the argument tagged tag at offset; false if it runs past size or the tag is unknown
+bool readArgument(char tag, const char* data, size_t size, size_t& offset, OscArgument& argument) {
+    argument.tag = tag;
+    argument.data = data + offset;
+    size_t fixedSize = 0;
+    switch (tag) {
+        case 'i': case 'f': case 'c': case 'r': case 'm':
+            fixedSize = 4;
+            break;
+        case 'h': case 't': case 'd':
+            fixedSize = 8;
+            break;
+        case 'T': case 'F': case 'N': case 'I': case '[': case ']':
+            fixedSize = 0;
+            break;
+        case 's': case 'S': {
+            std::string_view text;
+            if (!readString(data, size, offset, text)) {
+                return false;
+            }
+            argument.size = text.size();
+            return true;
+        }
+        case 'b': {
+            if (size - offset < 4) {
+                return false;
+            }
+            size_t length = oscReadUint32(data + offset);
+            if (length > size - offset - 4 || oscPadded(length) > size - offset - 4) {
+                return false;
+            }
+            argument.data = data + offset + 4;
+            argument.size = length;
+            offset += 4 + oscPadded(length);
+            return true;
+        }
+        default:
+            return false;
+    }
+    if (fixedSize > size - offset) {
+        return false;
+    }
+    argument.size = fixedSize;
+    offset += fixedSize;
+    return true;
+}
+
+uint64_t readUint64(const char* data) {
+    return (uint64_t{ oscReadUint32(data) } << 32) | oscReadUint32(data + 4);
+}
+
+// Matches the set after '[' against c; pattern is advanced past the closing ']'
+bool matchSet(std::string_view& pattern, char c) {
+    bool negated = !pattern.empty() && pattern.front() == '!';
+    if (negated) {
+        pattern.remove_prefix(1);
+    }
+    bool found = false;
+    while (!pattern.empty() && pattern.front() != ']') {
+        char low = pattern.front();
+        pattern.remove_prefix(1);
+        char high = low;
+        if (pattern.size() >= 2 && pattern.front() == '-' && pattern[1] != ']') {
+            high = pattern[1];
+            pattern.remove_prefix(2);
+        }
+        if (c >= low && c <= high) {
+            found = true;
+        }
+    }
+    if (!pattern.empty()) {
+        pattern.remove_prefix(1);
+    }
+    return found != negated;
+}
+
+// One match of an address pattern. '*' runs and '{' groups are the only
+// places a match can go more than one way; whether the pattern from such a
+// point matches the address from a given offset is worked out once and
+// remembered, so a match costs O(|pattern|·|address|) however the wildcards
+// are arranged. Patterns with more than kMaxBranches of them match nothing,
+// which also bounds the recursion.
+class PatternMatch {
+public:
+    static constexpr size_t kMaxBranches = 32;
+
+    PatternMatch(std::string_view pattern, std::string_view address)
+        : pattern_(pattern), address_(address) {
+    }
+
+    bool run() {
+        for (size_t i = 0; i < pattern_.size(); ++i) {
+            bool starRun = pattern_[i] == '*' && (i == 0 || pattern_[i - 1] != '*');
+            if (starRun || pattern_[i] == '{') {
+                if (branchCount_ == kMaxBranches) {
+                    return false;
+                }
+                branches_[branchCount_++] = i;
+            }
+        }
+        failed_.assign(branchCount_ * (address_.size() + 1), false);
+        return matchFrom(0, 0);
+    }
+
+private:
+    // Whether the pattern from offset p matches the address from offset a
+    bool matchFrom(size_t p, size_t a) {
+        while (p < pattern_.size()) {
+            char token = pattern_[p];
+            if (token == '*' || token == '{') {
+                return matchBranch(p, a);
+            }
+            if (a == address_.size()) {
+                return false;
+            }
+            char c = address_[a];
+            ++p;
+            if (token == '?') {
+                if (c == '/') {
+                    return false;
+                }
+            } else if (token == '[') {
+                std::string_view set = pattern_.substr(p);
+                if (c == '/' || !matchSet(set, c)) {
+                    return false;
+                }
+                p = pattern_.size() - set.size();
+            } else if (token != c) {
+                return false;
+            }
+            ++a;
+        }
+        return a == address_.size();
+    }
+
+    bool matchBranch(size_t p, size_t a) {
+        size_t branch = static_cast<size_t>(std::find(branches_.begin(), branches_.begin() + branchCount_, p)
+                                            - branches_.begin());
+        size_t slot = branch * (address_.size() + 1) + a;
+        if (failed_[slot]) {
+            return false;
+        }
+        bool matched = pattern_[p] == '*' ? matchStar(p, a) : matchChoice(p, a);
+        if (!matched) {
+            failed_[slot] = true;
+        }
+        return matched;
+    }
+
+    // Shortest stretch first; '*' never crosses a '/'
+    bool matchStar(size_t p, size_t a) {
+        size_t rest = pattern_.find_first_not_of('*', p);
+        if (rest == std::string_view::npos) {
+            rest = pattern_.size();
+        }
+        for (size_t skip = a; skip <= address_.size(); ++skip) {
+            if (matchFrom(rest, skip)) {
+                return true;
+            }
+            if (skip < address_.size() && address_[skip] == '/') {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool matchChoice(size_t p, size_t a) {
+        size_t close = pattern_.find('}', p);
+        if (close == std::string_view::npos) {
+            return false;
+        }
+        std::string_view choices = pattern_.substr(p + 1, close - p - 1);
+        while (true) {
+            size_t comma = choices.find(',');
+            std::string_view choice = choices.substr(0, comma);
+            if (address_.substr(a, choice.size()) == choice && matchFrom(close + 1, a + choice.size())) {
+                return true;
+            }
+            if (comma == std::string_view::npos) {
+                return false;
+            }
+            choices.remove_prefix(comma + 1);
+        }
+    }
+
+    std::string_view pattern_;
+    std::string_view address_;
+    // Pattern offsets of each '*' run and '{' group, in order
+    std::array<size_t, kMaxBranches> branches_{};
+    size_t branchCount_ = 0;
+    // Per branch and address offset: known not to match from there
+    std::vector<bool> failed_;
+};
+
+}
+
+std::optional<int32_t> OscArgument::asInt() const {
+    if (tag != 'i') {
+        return std::nullopt;
+    }
+    return static_cast<int32_t>(oscReadUint32(data));
+}
+
+std::optional<float> OscArgument::asFloat() const {
+    if (tag != 'f') {
+        return std::nullopt;
+    }
+    return std::bit_cast<float>(oscReadUint32(data));
+}
+
+std::optional<std::string_view> OscArgument::asString() const {
+    if (tag != 's' && tag != 'S') {
+        return std::nullopt;
+    }
+    return std::string_view(data, size);
+}
+
+bool OscArgument::truthy() const {
+    switch (tag) {
+        case 'T':
+            return true;
+        case 'i':
+            return oscReadUint32(data) != 0;
+        case 'f':
+            return std::bit_cast<float>(oscReadUint32(data)) != 0.0f;
+        case 'h':
+            return readUint64(data) != 0;
+        case 'd':
+            return std::bit_cast<double>(readUint64(data)) != 0.0;
+        default:
+            return false;
+    }
+}
+
+std::optional<OscMessageView> OscMessageView::parse(const char* data, size_t size) {
+    if (size % 4 != 0) {
+        return std::nullopt;
+    }
+
+    OscMessageView message;
+    size_t offset = 0;
+    if (!readString(data, size, offset, message.address_) || message.address_.empty()
+        || message.address_.front() != '/') {
+        return std::nullopt;
+    }
+
+    // Some old senders omit the type tags; that is a message without arguments
+    if (offset < size) {
+        std::string_view tags;
+        if (!readString(data, size, offset, tags) || tags.empty() || tags.front() != ',') {
+            return std::nullopt;
+        }
+        message.typeTags_ = tags.substr(1);
+    }
+    message.arguments_ = data + offset;
+    message.argumentsSize_ = size - offset;
+
+    OscArgument argument;
+    for (char tag : message.typeTags_) {
+        if (!readArgument(tag, data, size, offset, argument)) {
+            return std::nullopt;
+        }
+    }
+    if (offset != size) {
+        return std::nullopt;
+    }
+    return message;
+}
+
+OscArgument OscMessageView::argument(size_t index) const {
+    // parse() checked every argument, so the walk cannot run past the packet
+    OscArgument argument;
+    size_t offset = 0;
+    for (size_t i = 0; i <= index; ++i) {
+        readArgument(typeTags_[i], arguments_, argumentsSize_, offset, argument);
+    }
+    return argument;
+}
+
+bool oscPatternMatches(std::string_view pattern, std::string_view address) {
+    return PatternMatch(pattern, address).run();
+}
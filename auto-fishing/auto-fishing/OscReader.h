@@ -0,0 +1,94 @@
+#pragma once
+#include "OscWriter.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+// Big-endian 32-bit field at data
+inline uint32_t oscReadUint32(const char* data) {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+    return (uint32_t{ in[0] } << 24) | (uint32_t{ in[1] } << 16) | (uint32_t{ in[2] } << 8) | uint32_t{ in[3] };
+}
+
+// One argument of a received message. data points into the packet: the
+// 4 or 8 bytes of a number, a string's characters or a blob's bytes.
+struct OscArgument {
+    char tag = '\0';
+    const char* data = nullptr;
+    size_t size = 0;
+
+    std::optional<int32_t> asInt() const;
+    std::optional<float> asFloat() const;
+    std::optional<std::string_view> asString() const;
+    // T, or a nonzero number
+    bool truthy() const;
+};
+
+// One message of a received packet, checked once by parse() and then read in
+// place. Holds pointers into the packet and is only valid while it is.
+class OscMessageView {
+public:
+    // nullopt unless data holds exactly one well-formed message
+    static std::optional<OscMessageView> parse(const char* data, size_t size);
+
+    std::string_view address() const { return address_; }
+    // Tags of the arguments, without the leading ','
+    std::string_view typeTags() const { return typeTags_; }
+    size_t argumentCount() const { return typeTags_.size(); }
+    // Walks the arguments before it, so reading all of them in order is quadratic;
+    // messages carry a handful at most
+    OscArgument argument(size_t index) const;
+
+private:
+    std::string_view address_;
+    std::string_view typeTags_;
+    const char* arguments_ = nullptr;
+    size_t argumentsSize_ = 0;
+};
+
+// Calls onMessage(const OscMessageView&) for every message in a packet, those
+// in bundles included, in order. Bundle time tags are ignored: messages are
+// delivered as they arrive. False if the packet is malformed; messages before
+// the fault have been delivered by then.
+template <typename OnMessage>
+bool oscForEachMessage(const char* data, size_t size, OnMessage&& onMessage, size_t depth = 0);
+
+// OSC 1.0 address pattern match: '?' and '*' stand for any characters but
+// '/', "[a-z]" and "[!a-z]" for one in or out of a set, "{foo,bar}" for
+// either word. Anything else matches itself. Takes O(|pattern|·|address|);
+// a pattern with more than 32 '*' runs and '{' groups matches nothing.
+bool oscPatternMatches(std::string_view pattern, std::string_view address);
+
+template <typename OnMessage>
+bool oscForEachMessage(const char* data, size_t size, OnMessage&& onMessage, size_t depth) {
+    constexpr char kBundleTag[8] = { '#', 'b', 'u', 'n', 'd', 'l', 'e', '\0' };
+    if (size < sizeof(kBundleTag) || std::memcmp(data, kBundleTag, sizeof(kBundleTag)) != 0) {
+        std::optional<OscMessageView> message = OscMessageView::parse(data, size);
+        if (!message) {
+            return false;
+        }
+        onMessage(*message);
+        return true;
+    }
+
+    // "#bundle", a time tag, then elements each prefixed by its size
+    if (depth == OscWriter::kMaxBundleDepth || size < 16) {
+        return false;
+    }
+    size_t offset = 16;
+    while (offset < size) {
+        if (size - offset < 4) {
+            return false;
+        }
+        size_t elementSize = oscReadUint32(data + offset);
+        offset += 4;
+        if (elementSize % 4 != 0 || elementSize > size - offset
+            || !oscForEachMessage(data + offset, elementSize, onMessage, depth + 1)) {
+            return false;
+        }
+        offset += elementSize;
+    }
+    return true;
+}
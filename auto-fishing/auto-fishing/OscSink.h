@@ -0,0 +1,19 @@
+#pragma once
+#include <chrono>
+
+// Destination for the cycle's OSC input. OSCClient sends to VRChat; replays
+// substitute a sink that just records what would have been sent.
+class OscSink {
+public:
+    virtual ~OscSink() = default;
+
+    virtual bool sendClick(bool press) = 0;
+    // Sends the press and the release at once, time-tagged for when each
+    // should apply. False if this sink cannot, in which case nothing was sent.
+    virtual bool sendTimedClick(std::chrono::system_clock::time_point pressAt,
+                                std::chrono::system_clock::time_point releaseAt) {
+        (void)pressAt;
+        (void)releaseAt;
+        return false;
+    }
+};
@@ -0,0 +1,167 @@
+#include "OscTransport.h"
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+OscTransport::OscTransport() : sock_(INVALID_SOCKET), winsockStarted_(false) {
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "WSAStartup failed" << std::endl;
+        return;
+    }
+    winsockStarted_ = true;
+
+    sock_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock_ == INVALID_SOCKET) {
+        std::cerr << "Socket creation failed" << std::endl;
+    }
+}
+
+OscTransport::~OscTransport() {
+    if (sock_ != INVALID_SOCKET) {
+        closesocket(sock_);
+    }
+    if (winsockStarted_) {
+        WSACleanup();
+    }
+}
+
+bool OscTransport::isOpen() const {
+    return sock_ != INVALID_SOCKET;
+}
+
+bool OscTransport::send(const char* data, size_t size) {
+    if (!isOpen()) {
+        return false;
+    }
+    bool all = true;
+    for (size_t i = 0; i < targetCount_; ++i) {
+        Target& target = targets_[i];
+        int result = sendto(sock_, data, static_cast<int>(size), 0,
+                            (sockaddr*)&target.address, sizeof(target.address));
+        if (result == SOCKET_ERROR) {
+            recordError(target, WSAGetLastError());
+            all = false;
+        } else {
+            recordSent(target, size);
+        }
+    }
+    return all;
+}
+
+#else
+
+OscTransport::OscTransport() {
+    sock_ = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP);
+    if (sock_ < 0) {
+        std::cerr << "Socket creation failed" << std::endl;
+    }
+}
+
+OscTransport::~OscTransport() {
+    if (sock_ >= 0) {
+        close(sock_);
+    }
+}
+
+bool OscTransport::isOpen() const {
+    return sock_ >= 0;
+}
+
+bool OscTransport::send(const char* data, size_t size) {
+    if (!isOpen()) {
+        return false;
+    }
+    iovec payload{ const_cast<char*>(data), size };
+    std::array<mmsghdr, MAX_TARGETS> messages;
+    for (size_t i = 0; i < targetCount_; ++i) {
+        messages[i] = mmsghdr{};
+        messages[i].msg_hdr.msg_name = &targets_[i].address;
+        messages[i].msg_hdr.msg_namelen = sizeof(targets_[i].address);
+        messages[i].msg_hdr.msg_iov = &payload;
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // sendmmsg() stops at the first datagram that fails; note it and go on with the rest
+    bool all = true;
+    size_t next = 0;
+    while (next < targetCount_) {
+        int sent = sendmmsg(sock_, messages.data() + next, static_cast<unsigned int>(targetCount_ - next), 0);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            recordError(targets_[next], errno);
+            all = false;
+            ++next;
+            continue;
+        }
+        for (int i = 0; i < sent; ++i) {
+            recordSent(targets_[next + i], messages[next + i].msg_len);
+        }
+        next += static_cast<size_t>(sent);
+    }
+    return all;
+}
+
+#endif
+
+OscTransport::TargetId OscTransport::addTarget(const std::string& host, int port) {
+    if (targetCount_ >= targets_.size() || port <= 0 || port > 65535) {
+        return INVALID_TARGET;
+    }
+    Target& target = targets_[targetCount_];
+    memset(&target.address, 0, sizeof(target.address));
+    target.address.sin_family = AF_INET;
+    target.address.sin_port = htons(static_cast<unsigned short>(port));
+    if (inet_pton(AF_INET, host.c_str(), &target.address.sin_addr) != 1) {
+        // Not a literal; resolve the name once here, never on the send path
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        hints.ai_protocol = IPPROTO_UDP;
+        addrinfo* results = nullptr;
+        if (getaddrinfo(host.c_str(), nullptr, &hints, &results) != 0 || !results) {
+            return INVALID_TARGET;
+        }
+        target.address.sin_addr = reinterpret_cast<const sockaddr_in*>(results->ai_addr)->sin_addr;
+        freeaddrinfo(results);
+    }
+    target.target = OscTarget{ host, port };
+    return targetCount_++;
+}
+
+std::vector<OscTargetStats> OscTransport::getStats() const {
+    std::vector<OscTargetStats> stats;
+    stats.reserve(targetCount_);
+    for (size_t i = 0; i < targetCount_; ++i) {
+        const Target& target = targets_[i];
+        OscTargetStats entry{};
+        entry.target = target.target;
+        entry.packets = target.packets.load(std::memory_order_relaxed);
+        entry.bytes = target.bytes.load(std::memory_order_relaxed);
+        entry.errors = target.errors.load(std::memory_order_relaxed);
+        entry.lastError = target.lastError.load(std::memory_order_relaxed);
+        stats.push_back(entry);
+    }
+    return stats;
+}
+
+void OscTransport::recordSent(Target& target, size_t size) {
+    target.packets.fetch_add(1, std::memory_order_relaxed);
+    target.bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void OscTransport::recordError(Target& target, int error) {
+    target.errors.fetch_add(1, std::memory_order_relaxed);
+    target.lastError.store(error, std::memory_order_relaxed);
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <netinet/in.h>
+#endif
+
+// A VRChat client's OSC input
+struct OscTarget {
+    std::string host;
+    int port;
+};
+
+struct OscTargetStats {
+    OscTarget target;
+    uint64_t packets;
+    uint64_t bytes;
+    uint64_t errors;
+    // Socket error of the last failed send, 0 if none failed
+    int lastError;
+};
+
+// Sends every OSC packet to each of up to MAX_TARGETS destinations over one
+// UDP socket, so several VRChat clients on one machine, each listening on its
+// own port, take no socket or thread apiece. Linux hands all the datagrams to
+// the kernel in one sendmmsg(); Windows has no batched send to distinct
+// addresses, so it is one sendto() per destination. Counts what reached each
+// destination. Thread-safe once the targets are added.
+class OscTransport {
+public:
+    using TargetId = size_t;
+    static constexpr TargetId INVALID_TARGET = static_cast<TargetId>(-1);
+    static constexpr size_t MAX_TARGETS = 64;
+
+    OscTransport();
+    ~OscTransport();
+
+    OscTransport(const OscTransport&) = delete;
+    OscTransport& operator=(const OscTransport&) = delete;
+
+    bool isOpen() const;
+
+    // IPv4 address or host name, resolved to IPv4 now, and port;
+    // INVALID_TARGET if it does not resolve or the table is full. Only valid
+    // before the first send().
+    TargetId addTarget(const std::string& host, int port);
+    size_t targetCount() const { return targetCount_; }
+
+    // True if every target took the packet
+    bool send(const char* data, size_t size);
+
+    std::vector<OscTargetStats> getStats() const;
+
+private:
+    struct Target {
+        OscTarget target;
+        sockaddr_in address{};
+        std::atomic<uint64_t> packets{ 0 };
+        std::atomic<uint64_t> bytes{ 0 };
+        std::atomic<uint64_t> errors{ 0 };
+        std::atomic<int> lastError{ 0 };
+    };
+
+    void recordSent(Target& target, size_t size);
+    void recordError(Target& target, int error);
+
+#ifdef _WIN32
+    SOCKET sock_;
+    bool winsockStarted_;
+#else
+    int sock_;
+#endif
+    std::array<Target, MAX_TARGETS> targets_;
+    size_t targetCount_ = 0;
+};
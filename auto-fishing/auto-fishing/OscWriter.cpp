@@ -0,0 +1,124 @@
+#include "OscWriter.h"
+#include <cstring>
+
+namespace {
+constexpr char kBundleTag[8] = { '#', 'b', 'u', 'n', 'd', 'l', 'e', '\0' };
+}
+
+bool OscWriter::beginBundle(uint64_t timeTag) {
+    if (failed_ || depth_ == kMaxBundleDepth) {
+        failed_ = true;
+        return false;
+    }
+    size_t sizeSlot = kNoSlot;
+    if (!openElement(sizeSlot)) {
+        return false;
+    }
+    if (!writeBytes(kBundleTag, sizeof(kBundleTag)) || !writeUint64(timeTag)) {
+        return false;
+    }
+    bundleSlots_[depth_++] = sizeSlot;
+    return true;
+}
+
+bool OscWriter::endBundle() {
+    if (failed_ || depth_ == 0) {
+        failed_ = true;
+        return false;
+    }
+    return closeElement(bundleSlots_[--depth_], true);
+}
+
+void OscWriter::reset() {
+    size_ = 0;
+    failed_ = false;
+    depth_ = 0;
+}
+
+bool OscWriter::openElement(size_t& sizeSlot) {
+    if (failed_) {
+        return false;
+    }
+    if (depth_ == 0) {
+        // A packet holds exactly one top-level message or bundle
+        if (size_ != 0) {
+            failed_ = true;
+            return false;
+        }
+        sizeSlot = kNoSlot;
+        return true;
+    }
+    sizeSlot = size_;
+    return writeUint32(0);
+}
+
+bool OscWriter::closeElement(size_t sizeSlot, bool written) {
+    if (!written) {
+        failed_ = true;
+        return false;
+    }
+    if (sizeSlot != kNoSlot) {
+        putUint32(sizeSlot, static_cast<uint32_t>(size_ - sizeSlot - 4));
+    }
+    return true;
+}
+
+bool OscWriter::writeBytes(const void* bytes, size_t count) {
+    if (failed_ || count > capacity_ - size_) {
+        failed_ = true;
+        return false;
+    }
+    std::memcpy(buffer_ + size_, bytes, count);
+    size_ += count;
+    return true;
+}
+
+bool OscWriter::writeString(std::string_view text) {
+    size_t padded = oscStringSize(text.size());
+    if (failed_ || padded > capacity_ - size_) {
+        failed_ = true;
+        return false;
+    }
+    std::memcpy(buffer_ + size_, text.data(), text.size());
+    std::memset(buffer_ + size_ + text.size(), 0, padded - text.size());
+    size_ += padded;
+    return true;
+}
+
+bool OscWriter::writeBlob(const OscBlob& blob) {
+    size_t padded = oscPadded(blob.size);
+    if (failed_ || blob.size > UINT32_MAX || 4 + padded > capacity_ - size_) {
+        failed_ = true;
+        return false;
+    }
+    writeUint32(static_cast<uint32_t>(blob.size));
+    if (blob.size > 0) {
+        std::memcpy(buffer_ + size_, blob.data, blob.size);
+    }
+    std::memset(buffer_ + size_ + blob.size, 0, padded - blob.size);
+    size_ += padded;
+    return true;
+}
+
+bool OscWriter::writeUint32(uint32_t value) {
+    if (failed_ || 4 > capacity_ - size_) {
+        failed_ = true;
+        return false;
+    }
+    putUint32(size_, value);
+    size_ += 4;
+    return true;
+}
+
+bool OscWriter::writeUint64(uint64_t value) {
+    return writeUint32(static_cast<uint32_t>(value >> 32)) && writeUint32(static_cast<uint32_t>(value));
+}
+
+void OscWriter::putUint32(size_t offset, uint32_t value) {
+    // Big-endian
+    unsigned char* out = reinterpret_cast<unsigned char*>(buffer_ + offset);
+    out[0] = static_cast<unsigned char>(value >> 24);
+    out[1] = static_cast<unsigned char>(value >> 16);
+    out[2] = static_cast<unsigned char>(value >> 8);
+    out[3] = static_cast<unsigned char>(value);
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+// OSC aligns every field to 4 bytes
+constexpr size_t oscPadded(size_t size) {
+    return (size + 3) & ~size_t{ 3 };
+}
+
+// A string's size on the wire: its bytes, a terminator, then padding
+constexpr size_t oscStringSize(size_t length) {
+    return oscPadded(length + 1);
+}
+
+// NTP time tag for a wall-clock instant: seconds since 1900 in the high 32
+// bits, the fraction of a second in the low 32
+constexpr uint64_t oscTimeTag(std::chrono::system_clock::time_point at) {
+    constexpr uint64_t kSecondsFrom1900To1970 = 2208988800ull;
+    auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(at.time_since_epoch());
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch);
+    uint64_t nanos = static_cast<uint64_t>((sinceEpoch - seconds).count());
+    return ((static_cast<uint64_t>(seconds.count()) + kSecondsFrom1900To1970) << 32) + (nanos << 32) / 1000000000ull;
+}
+
+// Argument written as an OSC blob ('b'): a size, then the bytes, padded
+struct OscBlob {
+    const void* data;
+    size_t size;
+};
+
+// Serializes one OSC 1.0 packet, a message or a bundle of them, into a buffer
+// the caller owns. Never allocates. Arguments map to type tags by their C++
+// type: bool to T/F, other integers of up to 32 bits to i, float to f,
+// strings to s and OscBlob to b.
+//
+//   std::array<char, 256> buffer;
+//   OscWriter writer(buffer);
+//   writer.message("/avatar/parameters/Fishing", true, 0.5f);
+//
+// A call that would overflow the buffer, or is out of place (a second
+// top-level element, endBundle() with no open bundle), fails and leaves the
+// writer failed until reset(); check ok() or complete() before sending.
+class OscWriter {
+public:
+    // Time tag meaning "as soon as it arrives"
+    static constexpr uint64_t kImmediately = 1;
+    static constexpr size_t kMaxBundleDepth = 4;
+
+    OscWriter(char* buffer, size_t capacity) : buffer_(buffer), capacity_(capacity) {}
+    template <size_t N>
+    explicit OscWriter(std::array<char, N>& buffer) : OscWriter(buffer.data(), N) {}
+
+    template <typename... Args>
+    bool message(std::string_view address, const Args&... args);
+
+    // Messages and bundles written until the matching endBundle() go inside it
+    bool beginBundle(uint64_t timeTag = kImmediately);
+    bool endBundle();
+
+    // Starts over on the same buffer
+    void reset();
+
+    const char* data() const { return buffer_; }
+    size_t size() const { return size_; }
+    bool ok() const { return !failed_; }
+    // A whole packet: nothing failed and every bundle is closed
+    bool complete() const { return !failed_ && depth_ == 0 && size_ > 0; }
+
+private:
+    static constexpr size_t kNoSlot = static_cast<size_t>(-1);
+
+    template <typename T>
+    static constexpr char typeTag(const T& value);
+
+    // Reserves the size field of an element inside a bundle
+    bool openElement(size_t& sizeSlot);
+    bool closeElement(size_t sizeSlot, bool written);
+
+    bool writeBytes(const void* bytes, size_t count);
+    bool writeString(std::string_view text);
+    bool writeBlob(const OscBlob& blob);
+    bool writeUint32(uint32_t value);
+    bool writeUint64(uint64_t value);
+    void putUint32(size_t offset, uint32_t value);
+    template <typename T>
+    bool writeArg(const T& value);
+
+    char* buffer_;
+    size_t capacity_;
+    size_t size_ = 0;
+    bool failed_ = false;
+    // Offsets of the size fields of the open bundles; kNoSlot for a top-level one
+    std::array<size_t, kMaxBundleDepth> bundleSlots_{};
+    size_t depth_ = 0;
+};
+
+template <typename T>
+constexpr char OscWriter::typeTag(const T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return value ? 'T' : 'F';
+    } else if constexpr (std::is_integral_v<T>) {
+        static_assert(sizeof(T) <= 4, "OSC integers are 32 bits");
+        return 'i';
+    } else if constexpr (std::is_same_v<T, float>) {
+        return 'f';
+    } else if constexpr (std::is_same_v<T, OscBlob>) {
+        return 'b';
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        return 's';
+    } else {
+        static_assert(sizeof(T) == 0, "no OSC type for this argument; pass floats as float");
+        return '\0';
+    }
+}
+
+template <typename T>
+bool OscWriter::writeArg(const T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        // T and F carry no data
+        return true;
+    } else if constexpr (std::is_integral_v<T>) {
+        return writeUint32(static_cast<uint32_t>(static_cast<int32_t>(value)));
+    } else if constexpr (std::is_same_v<T, float>) {
+        return writeUint32(std::bit_cast<uint32_t>(value));
+    } else if constexpr (std::is_same_v<T, OscBlob>) {
+        return writeBlob(value);
+    } else {
+        return writeString(std::string_view(value));
+    }
+}
+
+template <typename... Args>
+bool OscWriter::message(std::string_view address, const Args&... args) {
+    if (address.empty() || address.front() != '/') {
+        failed_ = true;
+        return false;
+    }
+    size_t sizeSlot = kNoSlot;
+    if (!openElement(sizeSlot)) {
+        return false;
+    }
+
+    // ',' and one tag per argument, terminated and padded; the size is fixed by the argument count
+    std::array<char, oscStringSize(1 + sizeof...(Args))> tags{};
+    tags[0] = ',';
+    [[maybe_unused]] size_t next = 1;
+    ((tags[next++] = typeTag(args)), ...);
+
+    bool written = writeString(address) && writeBytes(tags.data(), tags.size()) && (writeArg(args) && ...);
+    return closeElement(sizeSlot, written);
+}
@@ -0,0 +1,80 @@
+#include "P2Quantile.h"
+#include <algorithm>
+#include <cmath>
+
+P2Quantile::P2Quantile(double p)
+    : p_(p),
+      positions_{ 0.0, 1.0, 2.0, 3.0, 4.0 },
+      desired_{ 0.0, 2.0 * p, 4.0 * p, 2.0 + 2.0 * p, 4.0 },
+      increments_{ 0.0, p / 2.0, p, (1.0 + p) / 2.0, 1.0 } {
+}
+
+void P2Quantile::add(double x) {
+    if (count_ < heights_.size()) {
+        heights_[count_++] = x;
+        std::sort(heights_.begin(), heights_.begin() + count_);
+        return;
+    }
+    ++count_;
+
+    // Cell the observation falls in; the extreme markers follow new extremes
+    int k;
+    if (x < heights_[0]) {
+        heights_[0] = x;
+        k = 0;
+    } else if (x >= heights_[4]) {
+        heights_[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= heights_[k + 1]) {
+            ++k;
+        }
+    }
+    for (int i = k + 1; i < 5; ++i) {
+        positions_[i] += 1.0;
+    }
+    for (int i = 0; i < 5; ++i) {
+        desired_[i] += increments_[i];
+    }
+
+    // Move the middle markers back toward their desired positions
+    for (int i = 1; i <= 3; ++i) {
+        double drift = desired_[i] - positions_[i];
+        if ((drift >= 1.0 && positions_[i + 1] - positions_[i] > 1.0)
+            || (drift <= -1.0 && positions_[i - 1] - positions_[i] < -1.0)) {
+            int step = drift > 0.0 ? 1 : -1;
+            double candidate = parabolic(i, step);
+            if (heights_[i - 1] < candidate && candidate < heights_[i + 1]) {
+                heights_[i] = candidate;
+            } else {
+                heights_[i] = linear(i, step);
+            }
+            positions_[i] += step;
+        }
+    }
+}
+
+double P2Quantile::estimate() const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    if (count_ <= heights_.size()) {
+        // Nearest rank among the observations so far, which are kept sorted
+        size_t rank = static_cast<size_t>(std::ceil(p_ * count_));
+        return heights_[(std::max)(rank, size_t{ 1 }) - 1];
+    }
+    return heights_[2];
+}
+
+double P2Quantile::parabolic(int i, double d) const {
+    const auto& q = heights_;
+    const auto& n = positions_;
+    return q[i] + d / (n[i + 1] - n[i - 1])
+        * ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i])
+         + (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+double P2Quantile::linear(int i, int d) const {
+    return heights_[i] + d * (heights_[i + d] - heights_[i]) / (positions_[i + d] - positions_[i]);
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// Streaming estimate of one quantile in constant memory (Jain & Chlamtac's P²
+// algorithm): five markers track the minimum, p/2, p, (1+p)/2 and the maximum,
+// and are nudged along a parabola as observations arrive. Exact for the first
+// five observations.
+class P2Quantile {
+public:
+    // p in (0, 1), e.g. 0.9 for the 90th percentile
+    explicit P2Quantile(double p);
+
+    void add(double x);
+    // 0 before the first observation
+    double estimate() const;
+    uint64_t count() const { return count_; }
+    double probability() const { return p_; }
+
+private:
+    double parabolic(int i, double d) const;
+    double linear(int i, int d) const;
+
+    double p_;
+    uint64_t count_ = 0;
+    std::array<double, 5> heights_{};
+    std::array<double, 5> positions_{};
+    std::array<double, 5> desired_{};
+    std::array<double, 5> increments_{};
+};
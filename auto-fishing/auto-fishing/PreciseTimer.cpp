@@ -0,0 +1,87 @@
+#include "PreciseTimer.h"
+
+PreciseTimer::PreciseTimer(FishingClock& clock, std::chrono::steady_clock::duration spinMargin)
+    : clock_(clock), spinMargin_(spinMargin)
+{
+    thread_ = std::thread(&PreciseTimer::run, this);
+}
+
+PreciseTimer::~PreciseTimer() {
+    shutdown();
+}
+
+void PreciseTimer::fireAt(std::chrono::steady_clock::time_point deadline, std::function<void()> action) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        ++generation_;
+        deadline_ = deadline;
+        action_ = std::move(action);
+    }
+    changed_.notify_one();
+}
+
+bool PreciseTimer::cancel() {
+    bool pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++generation_;
+        pending = static_cast<bool>(action_);
+        action_ = nullptr;
+    }
+    changed_.notify_one();
+    return pending;
+}
+
+void PreciseTimer::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+        action_ = nullptr;
+    }
+    changed_.notify_one();
+    if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+        thread_.join();
+    }
+}
+
+void PreciseTimer::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (!action_) {
+            changed_.wait(lock);
+            continue;
+        }
+
+        // Coarse sleep; a new action or a cancel wakes it to start over
+        uint64_t generation = generation_;
+        if (clock_.now() < deadline_ - spinMargin_) {
+            clock_.waitUntil(changed_, lock, deadline_ - spinMargin_);
+            continue;
+        }
+
+        auto deadline = deadline_;
+        lock.unlock();
+        while (clock_.now() < deadline) {
+            std::this_thread::yield();
+        }
+        lock.lock();
+        if (stopping_ || generation != generation_ || !action_) {
+            continue;
+        }
+
+        std::function<void()> action = std::move(action_);
+        action_ = nullptr;
+        lock.unlock();
+        try {
+            action();
+        } catch (...) {
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "FishingClock.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Runs one action at a time at a precise deadline, on its own thread. A plain
+// timed wait wakes late by up to the OS timer period (15.6ms on Windows by
+// default), so the thread sleeps until spinMargin before the deadline and
+// spins, yielding, for the rest. Costs a core for spinMargin per action.
+class PreciseTimer {
+public:
+    PreciseTimer(FishingClock& clock, std::chrono::steady_clock::duration spinMargin);
+    ~PreciseTimer();
+
+    PreciseTimer(const PreciseTimer&) = delete;
+    PreciseTimer& operator=(const PreciseTimer&) = delete;
+
+    // Replaces the pending action, if any
+    void fireAt(std::chrono::steady_clock::time_point deadline, std::function<void()> action);
+    // True if an action was pending and now will not run; false if there was
+    // none or it is already running
+    bool cancel();
+    void shutdown();
+
+private:
+    void run();
+
+    FishingClock& clock_;
+    std::chrono::steady_clock::duration spinMargin_;
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::function<void()> action_;
+    std::chrono::steady_clock::time_point deadline_;
+    // Bumped by every fireAt() and cancel() so a spin in progress notices
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+    std::thread thread_;
+};
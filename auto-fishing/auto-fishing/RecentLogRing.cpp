@@ -0,0 +1,33 @@
+#include "RecentLogRing.h"
+
+RecentLogRing::RecentLogRing(size_t capacity)
+    : records_(capacity > 0 ? capacity : 1)
+{
+}
+
+void RecentLogRing::push(uint32_t typeMask, const std::optional<std::chrono::system_clock::time_point>& timestamp) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Record& record = records_[nextSequence_ % records_.size()];
+    record.sequence = nextSequence_++;
+    record.typeMask = typeMask;
+    record.timestamp = timestamp;
+}
+
+bool RecentLogRing::findSince(LogEventType type, std::chrono::system_clock::time_point minTime, uint64_t& cursor) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint32_t wanted = 1u << static_cast<uint32_t>(type);
+    const uint64_t capacity = records_.size();
+    const uint64_t oldest = nextSequence_ > capacity ? nextSequence_ - capacity : 1;
+    uint64_t sequence = cursor + 1 > oldest ? cursor + 1 : oldest;
+
+    for (; sequence < nextSequence_; ++sequence) {
+        const Record& record = records_[sequence % capacity];
+        if ((record.typeMask & wanted) && record.timestamp && *record.timestamp >= minTime) {
+            cursor = sequence;
+            return true;
+        }
+    }
+    cursor = nextSequence_ - 1;
+    return false;
+}
+
@@ -0,0 +1,34 @@
+#pragma once
+#include "LogEvent.h"
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+// Bounded history of the event types and parsed timestamps of recently
+// ingested keyword lines, so callers can look for an event without re-reading
+// the log.
+class RecentLogRing {
+public:
+    explicit RecentLogRing(size_t capacity);
+
+    // typeMask has bit i set for each event type index the line matched
+    void push(uint32_t typeMask, const std::optional<std::chrono::system_clock::time_point>& timestamp);
+
+    // Scans records newer than cursor for one of the given type stamped at or after
+    // minTime. cursor is advanced past every record examined, so repeated calls
+    // only look at lines ingested since the previous call; start it at 0.
+    bool findSince(LogEventType type, std::chrono::system_clock::time_point minTime, uint64_t& cursor) const;
+
+private:
+    struct Record {
+        uint64_t sequence = 0;
+        uint32_t typeMask = 0;
+        std::optional<std::chrono::system_clock::time_point> timestamp;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Record> records_;
+    uint64_t nextSequence_ = 1;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+// x86 vector support shared by the log scanning kernels.
+// SSE2 is baseline on x64; AVX2 paths are compiled in and selected at runtime.
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUTOFISHING_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(AUTOFISHING_SSE2) && (defined(_MSC_VER) || defined(__GNUC__))
+#define AUTOFISHING_AVX2 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AUTOFISHING_TARGET_AVX2
+#else
+#define AUTOFISHING_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+inline unsigned lowestSetBit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline bool cpuHasAvx2() {
+#if defined(AUTOFISHING_AVX2) && defined(_MSC_VER)
+    static const bool supported = []() {
+        int info[4] = {};
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }();
+    return supported;
+#elif defined(AUTOFISHING_AVX2)
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
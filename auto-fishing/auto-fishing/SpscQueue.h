@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free single-producer/single-consumer ring.
+// tryPush() may only be called from one thread and tryPop() from one other thread.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity)
+        : capacity_(roundUpToPowerOfTwo(capacity))
+        , mask_(capacity_ - 1)
+        , slots_(new T[capacity_])
+    {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Returns false (and leaves value untouched) when the queue is full
+    bool tryPush(T&& value) {
+        return tryPushWith([&](T& slot) { slot = std::move(value); });
+    }
+
+    bool tryPop(T& out) {
+        return tryPopWith([&](T& slot) { out = std::move(slot); });
+    }
+
+    // Calls fill(T&) on the next free slot, so elements that own storage can
+    // reuse it rather than be moved in; false when the queue is full
+    template <typename Fill>
+    bool tryPushWith(Fill&& fill) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ >= capacity_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ >= capacity_) {
+                return false;
+            }
+        }
+        fill(slots_[tail & mask_]);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Calls use(T&) on the oldest element, which stays in place until use returns
+    template <typename Use>
+    bool tryPopWith(Use&& use) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return false;
+            }
+        }
+        use(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Exact from either endpoint thread, approximate from anywhere else
+    size_t sizeApprox() const noexcept {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    size_t capacity() const noexcept { return capacity_; }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    // Producer and consumer indices live on separate cache lines
+    alignas(64) std::atomic<size_t> tail_{ 0 };
+    size_t cachedHead_ = 0;
+    alignas(64) std::atomic<size_t> head_{ 0 };
+    size_t cachedTail_ = 0;
+};
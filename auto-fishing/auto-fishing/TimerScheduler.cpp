@@ -0,0 +1,125 @@
+#include "TimerScheduler.h"
+
+TimerScheduler::TimerScheduler(FishingClock& clock, Mode mode)
+    : clock_(clock)
+{
+    if (mode == Mode::Threaded) {
+        thread_ = std::thread(&TimerScheduler::run, this);
+    }
+}
+
+TimerScheduler::~TimerScheduler() {
+    shutdown();
+}
+
+TimerScheduler::TimerId TimerScheduler::schedule(std::chrono::steady_clock::duration delay, std::function<void()> callback) {
+    TimerId id;
+    bool earliest;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return INVALID_TIMER;
+        }
+        id = nextId_++;
+        auto at = clock_.now() + delay;
+        earliest = deadlines_.empty() || at < deadlines_.top().at;
+        deadlines_.push({ at, id });
+        callbacks_.emplace(id, std::move(callback));
+    }
+    // Only a new earliest deadline changes how long the thread should sleep
+    if (earliest) {
+        changed_.notify_one();
+    }
+    return id;
+}
+
+bool TimerScheduler::cancel(TimerId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return callbacks_.erase(id) > 0;
+}
+
+void TimerScheduler::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+        callbacks_.clear();
+    }
+    changed_.notify_one();
+    if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+        thread_.join();
+    }
+}
+
+size_t TimerScheduler::pendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return callbacks_.size();
+}
+
+size_t TimerScheduler::runDue() {
+    size_t fired = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::function<void()> callback;
+    while (!stopping_ && popDue(callback)) {
+        lock.unlock();
+        try {
+            callback();
+        } catch (...) {
+        }
+        ++fired;
+        lock.lock();
+    }
+    return fired;
+}
+
+std::optional<std::chrono::steady_clock::time_point> TimerScheduler::nextDeadline() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    discardCancelled();
+    if (deadlines_.empty()) {
+        return std::nullopt;
+    }
+    return deadlines_.top().at;
+}
+
+void TimerScheduler::discardCancelled() {
+    while (!deadlines_.empty() && callbacks_.count(deadlines_.top().id) == 0) {
+        deadlines_.pop();
+    }
+}
+
+bool TimerScheduler::popDue(std::function<void()>& callback) {
+    discardCancelled();
+    if (deadlines_.empty() || clock_.now() < deadlines_.top().at) {
+        return false;
+    }
+    Deadline next = deadlines_.top();
+    deadlines_.pop();
+    auto it = callbacks_.find(next.id);
+    callback = std::move(it->second);
+    callbacks_.erase(it);
+    return true;
+}
+
+void TimerScheduler::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::function<void()> callback;
+    while (!stopping_) {
+        if (popDue(callback)) {
+            lock.unlock();
+            try {
+                callback();
+            } catch (...) {
+            }
+            lock.lock();
+            continue;
+        }
+
+        if (deadlines_.empty()) {
+            changed_.wait(lock);
+        } else {
+            clock_.waitUntil(changed_, lock, deadlines_.top().at);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "FishingClock.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// One-shot timers served by a single thread from a min-heap of deadlines.
+// The thread blocks without waking while nothing is armed. Callbacks run on
+// the scheduler thread and must not block; hand long work to another thread.
+// In Manual mode there is no thread and the owner fires timers with runDue().
+class TimerScheduler {
+public:
+    using TimerId = uint64_t;
+    static constexpr TimerId INVALID_TIMER = 0;
+
+    enum class Mode { Threaded, Manual };
+
+    explicit TimerScheduler(FishingClock& clock, Mode mode = Mode::Threaded);
+    ~TimerScheduler();
+
+    TimerScheduler(const TimerScheduler&) = delete;
+    TimerScheduler& operator=(const TimerScheduler&) = delete;
+
+    TimerId schedule(std::chrono::steady_clock::duration delay, std::function<void()> callback);
+
+    // True if the timer was still pending; false if it already fired, is firing
+    // right now, or was never armed
+    bool cancel(TimerId id);
+
+    // Drops every pending timer and joins the thread
+    void shutdown();
+
+    size_t pendingCount() const;
+
+    // Runs every timer due at clock.now() on the calling thread, including ones
+    // they arm for the same instant; returns how many ran
+    size_t runDue();
+    // Earliest deadline of a timer that is still armed
+    std::optional<std::chrono::steady_clock::time_point> nextDeadline();
+
+private:
+    struct Deadline {
+        std::chrono::steady_clock::time_point at;
+        TimerId id;
+        // Equal deadlines fire in the order they were armed
+        bool operator>(const Deadline& other) const {
+            return at > other.at || (at == other.at && id > other.id);
+        }
+    };
+
+    void run();
+    // Drops deadlines of cancelled timers from the top of the heap; needs mutex_
+    void discardCancelled();
+    // Pops the earliest timer if it is due; needs mutex_
+    bool popDue(std::function<void()>& callback);
+
+    FishingClock& clock_;
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    // Cancelled timers are erased from callbacks_ and skipped when their deadline surfaces
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines_;
+    std::unordered_map<TimerId, std::function<void()>> callbacks_;
+    TimerId nextId_ = 1;
+    bool stopping_ = false;
+    std::thread thread_;
+};
@@ -1,18 +1,27 @@
 #include "VRChatLogHandler.h"
 #include "FishingConfig.h"
+#include "LineSplitter.h"
+#include "LogTimestamp.h"
 #include <shlobj.h>
 #include <algorithm>
-#include <sstream>
+#include <iostream>
 
-VRChatLogHandler::VRChatLogHandler(LogCallback callback)
-    : callback_(std::move(callback))
+VRChatLogHandler::VRChatLogHandler(FishingClock& clock, LogCallback callback)
+    : clock_(clock)
+    , callback_(std::move(callback))
+    , recentEvents_(FishingConfig::RECENT_EVENT_CAPACITY)
     , running_(false)
-    , stopEvent_(NULL)
-    , fileChangeEvent_(NULL)
     , logFileHandle_(INVALID_HANDLE_VALUE)
-    , incompleteLineBuffer_()
+    , eventQueue_(FishingConfig::LOG_EVENT_QUEUE_CAPACITY)
+    , eventReadyEvent_(NULL)
+    , eventsQueued_(0)
+    , eventsDropped_(0)
+    , queueHighWater_(0)
 {
     filePosition_.QuadPart = 0;
+    addKeyword(FISH_HOOK_KEYWORD, LogEventType::FishOnHook);
+    addKeyword(FISH_PICKUP_KEYWORD, LogEventType::FishPickup);
+    addKeyword(BUCKET_SAVE_KEYWORD, LogEventType::BucketSave);
     logDirectory_ = getVRChatLogDir();
     updateLogFile();
 }
@@ -21,27 +30,33 @@ VRChatLogHandler::~VRChatLogHandler() {
     stop();
 }
 
+bool VRChatLogHandler::addKeyword(std::string_view keyword, LogEventType type) {
+    int index = matcher_.addPattern(keyword);
+    if (index < 0) {
+        return false;
+    }
+    typeMasks_[static_cast<size_t>(type)] |= KeywordMatcher::Mask{ 1 } << index;
+    return true;
+}
+
 void VRChatLogHandler::startMonitor() {
     bool expected = false;
     if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
         return;
     }
 
-    stopEvent_ = CreateEventW(NULL, TRUE, FALSE, NULL);
-    if (!stopEvent_) {
+    matcher_.compile();
+
+    eventReadyEvent_ = CreateEventW(NULL, FALSE, FALSE, NULL);
+    if (!eventReadyEvent_) {
         running_ = false;
         return;
     }
 
-    if (!logDirectory_.empty()) {
-        fileChangeEvent_ = FindFirstChangeNotificationW(
-            logDirectory_.c_str(),
-            FALSE,
-            FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE
-        );
-    }
+    changeSource_ = LogChangeSource::create();
+    changeSource_->open(logDirectory_);
 
-    watchThread_ = std::thread(&VRChatLogHandler::directoryWatchThread, this);
+    dispatchThread_ = std::thread(&VRChatLogHandler::dispatchThread, this);
     readThread_ = std::thread(&VRChatLogHandler::fileReadThread, this);
 }
 
@@ -51,81 +66,34 @@ void VRChatLogHandler::stop() {
         return;
     }
 
-    if (stopEvent_) {
-        SetEvent(stopEvent_);
+    if (changeSource_) {
+        changeSource_->interrupt();
     }
-
-    if (watchThread_.joinable()) {
-        watchThread_.join();
+    if (eventReadyEvent_) {
+        SetEvent(eventReadyEvent_);
     }
+
     if (readThread_.joinable()) {
         readThread_.join();
     }
+    if (dispatchThread_.joinable()) {
+        dispatchThread_.join();
+    }
+    changeSource_.reset();
 
-    if (fileChangeEvent_ && fileChangeEvent_ != INVALID_HANDLE_VALUE) {
-        FindCloseChangeNotification(fileChangeEvent_);
-        fileChangeEvent_ = NULL;
+    if (eventReadyEvent_) {
+        CloseHandle(eventReadyEvent_);
+        eventReadyEvent_ = NULL;
     }
 
     if (logFileHandle_ != INVALID_HANDLE_VALUE) {
         CloseHandle(logFileHandle_);
         logFileHandle_ = INVALID_HANDLE_VALUE;
     }
-
-    if (stopEvent_) {
-        CloseHandle(stopEvent_);
-        stopEvent_ = NULL;
-    }
 }
 
-std::string VRChatLogHandler::safeReadFile() {
-    return readNewContent();
-}
-
-std::string VRChatLogHandler::readTail(size_t maxBytes) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    if (currentLogPath_.empty()) {
-        return "";
-    }
-
-    HANDLE tailHandle = CreateFileW(
-        currentLogPath_.c_str(),
-        GENERIC_READ,
-        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
-        NULL,
-        OPEN_EXISTING,
-        FILE_ATTRIBUTE_NORMAL,
-        NULL
-    );
-    if (tailHandle == INVALID_HANDLE_VALUE) {
-        return "";
-    }
-
-    LARGE_INTEGER fileSize{};
-    if (!GetFileSizeEx(tailHandle, &fileSize) || fileSize.QuadPart <= 0) {
-        CloseHandle(tailHandle);
-        return "";
-    }
-
-    LONGLONG bytesToRead = static_cast<LONGLONG>(maxBytes);
-    if (bytesToRead > fileSize.QuadPart) {
-        bytesToRead = fileSize.QuadPart;
-    }
-    LARGE_INTEGER startPos{};
-    startPos.QuadPart = fileSize.QuadPart - bytesToRead;
-    SetFilePointerEx(tailHandle, startPos, NULL, FILE_BEGIN);
-
-    std::string buffer(static_cast<size_t>(bytesToRead), '\0');
-    DWORD bytesRead = 0;
-    if (!ReadFile(tailHandle, buffer.data(), static_cast<DWORD>(bytesToRead), &bytesRead, NULL) || bytesRead == 0) {
-        CloseHandle(tailHandle);
-        return "";
-    }
-
-    buffer.resize(bytesRead);
-    CloseHandle(tailHandle);
-    return buffer;
+bool VRChatLogHandler::findRecentEvent(LogEventType type, std::chrono::system_clock::time_point minTime, uint64_t& cursor) const {
+    return recentEvents_.findSince(type, minTime, cursor);
 }
 
 std::string VRChatLogHandler::getCurrentLogPath() const {
@@ -140,6 +108,16 @@ std::string VRChatLogHandler::getCurrentLogPath() const {
     return result;
 }
 
+LogEventQueueStats VRChatLogHandler::getEventQueueStats() const {
+    LogEventQueueStats stats{};
+    stats.depth = eventQueue_.sizeApprox();
+    stats.highWater = queueHighWater_.load(std::memory_order_relaxed);
+    stats.capacity = eventQueue_.capacity();
+    stats.queued = eventsQueued_.load(std::memory_order_relaxed);
+    stats.dropped = eventsDropped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
 std::wstring VRChatLogHandler::getVRChatLogDir() const {
     PWSTR localLowPath = nullptr;
     HRESULT hr = SHGetKnownFolderPath(FOLDERID_LocalAppDataLow, 0, nullptr, &localLowPath);
@@ -211,6 +189,7 @@ bool VRChatLogHandler::updateLogFile() {
     }
 
     currentLogPath_ = newLog;
+    readBuffer_.clear();
 
     logFileHandle_ = CreateFileW(
         currentLogPath_.c_str(),
@@ -235,145 +214,154 @@ bool VRChatLogHandler::updateLogFile() {
     return true;
 }
 
-void VRChatLogHandler::directoryWatchThread() {
-    HANDLE handles[2] = { stopEvent_, fileChangeEvent_ };
-    int handleCount = fileChangeEvent_ ? 2 : 1;
+void VRChatLogHandler::fileReadThread() {
+    // A notification wakes the reader at once. NTFS defers them for a file the
+    // writer keeps open, as VRChat does its log, so the poll stays at the old rate.
+    const auto interval = std::chrono::milliseconds(static_cast<int>(FishingConfig::LOG_CHECK_INTERVAL * 1000));
 
     while (running_.load(std::memory_order_acquire)) {
-        DWORD waitResult = WaitForMultipleObjects(
-            handleCount,
-            handles,
-            FALSE,
-            static_cast<DWORD>(FishingConfig::LOG_CHECK_INTERVAL * 1000)
-        );
-
-        if (!running_.load(std::memory_order_acquire)) {
-            break;
-        }
+        LogChangeKind change = changeSource_->wait(interval);
 
-        if (waitResult == WAIT_OBJECT_0) {
+        if (!running_.load(std::memory_order_acquire) || change == LogChangeKind::Stopped) {
             break;
         }
 
-        updateLogFile();
-
-        if (waitResult == WAIT_OBJECT_0 + 1 && fileChangeEvent_) {
-            FindNextChangeNotification(fileChangeEvent_);
+        if (change != LogChangeKind::Modified) {
+            updateLogFile();
         }
+
+        drainLogFile();
     }
 }
 
-void VRChatLogHandler::fileReadThread() {
-    while (running_.load(std::memory_order_acquire)) {
-        DWORD waitResult = WaitForSingleObject(
-            stopEvent_,
-            static_cast<DWORD>(FishingConfig::LOG_CHECK_INTERVAL * 1000)
-        );
-
-        if (!running_.load(std::memory_order_acquire) || waitResult == WAIT_OBJECT_0) {
-            break;
-        }
-
-        std::string content = readNewContent();
-        if (!content.empty()) {
-            processLogContent(content);
-        }
+void VRChatLogHandler::drainLogFile() {
+    // Only this thread touches readBuffer_, so lines are processed outside mutex_
+    std::string_view lines;
+    uint64_t fileOffset = 0;
+    while (running_.load(std::memory_order_acquire) && readNewContent(lines, fileOffset)) {
+        processLogContent(lines, fileOffset);
+        readBuffer_.consume(lines.size());
     }
 }
 
-std::string VRChatLogHandler::readNewContent() {
+bool VRChatLogHandler::readNewContent(std::string_view& completeLines, uint64_t& fileOffset) {
     std::lock_guard<std::mutex> lock(mutex_);
+    completeLines = std::string_view();
+    fileOffset = 0;
 
     if (logFileHandle_ == INVALID_HANDLE_VALUE) {
-        return "";
+        return false;
     }
 
     LARGE_INTEGER fileSize;
     if (!GetFileSizeEx(logFileHandle_, &fileSize)) {
-        return "";
+        return false;
     }
 
     if (filePosition_.QuadPart > fileSize.QuadPart) {
         filePosition_.QuadPart = 0;
-        incompleteLineBuffer_.clear();
-        SetFilePointerEx(logFileHandle_, filePosition_, NULL, FILE_BEGIN);
+        readBuffer_.clear();
     }
 
-    if (filePosition_.QuadPart >= fileSize.QuadPart) {
-        return "";
+    LONGLONG bytesToRead = fileSize.QuadPart - filePosition_.QuadPart;
+    if (bytesToRead <= 0) {
+        return false;
+    }
+    if (bytesToRead > static_cast<LONGLONG>(FishingConfig::LOG_READ_CHUNK_BYTES)) {
+        bytesToRead = static_cast<LONGLONG>(FishingConfig::LOG_READ_CHUNK_BYTES);
     }
 
-    LONGLONG bytesToRead = fileSize.QuadPart - filePosition_.QuadPart;
-    if (bytesToRead <= 0 || bytesToRead > 10 * 1024 * 1024) {
-        return "";
+    // A runaway line with no newline would otherwise grow the buffer forever
+    if (readBuffer_.size() > FishingConfig::LOG_MAX_LINE_BYTES) {
+        readBuffer_.clear();
     }
 
-    std::string buffer(static_cast<size_t>(bytesToRead), '\0');
+    char* target = readBuffer_.prepare(static_cast<size_t>(bytesToRead));
     DWORD bytesRead = 0;
 
     SetFilePointerEx(logFileHandle_, filePosition_, NULL, FILE_BEGIN);
-    
-    if (!ReadFile(logFileHandle_, buffer.data(), static_cast<DWORD>(bytesToRead), &bytesRead, NULL)) {
-        return "";
+
+    if (!ReadFile(logFileHandle_, target, static_cast<DWORD>(bytesToRead), &bytesRead, NULL) || bytesRead == 0) {
+        return false;
     }
 
-    if (bytesRead == 0) {
-        return "";
+    readBuffer_.commit(bytesRead);
+    filePosition_.QuadPart += bytesRead;
+    completeLines = readBuffer_.completeLines();
+    fileOffset = static_cast<uint64_t>(filePosition_.QuadPart) - readBuffer_.size();
+    return true;
+}
+
+void VRChatLogHandler::processLine(std::string_view line, uint64_t fileOffset) {
+    if (!callback_) {
+        return;
     }
 
-    buffer.resize(bytesRead);
+    KeywordMatcher::Mask hits = matcher_.scan(line);
+    if (hits == 0) {
+        return;
+    }
 
-    std::string fullContent = incompleteLineBuffer_ + buffer;
-    
-    size_t lastNewline = fullContent.rfind('\n');
-    
-    if (lastNewline == std::string::npos) {
-        incompleteLineBuffer_ = fullContent;
-        filePosition_.QuadPart += bytesRead;
-        return "";
+    uint32_t typeMask = 0;
+    for (LogEventType type : kLogEventTypes) {
+        if (hits & typeMasks_[static_cast<size_t>(type)]) {
+            typeMask |= 1u << static_cast<uint32_t>(type);
+        }
     }
 
-    std::string completeLines = fullContent.substr(0, lastNewline + 1);
-    incompleteLineBuffer_ = fullContent.substr(lastNewline + 1);
-    
-    filePosition_.QuadPart += bytesRead;
+    LogEvent event{};
+    event.timestamp = parseLogTimestamp(line);
+    event.observedAt = clock_.now();
+    event.fileOffset = fileOffset;
+
+    // Record before dispatch so lookups see the line even while the dispatcher is busy
+    recentEvents_.push(typeMask, event.timestamp);
 
-    return completeLines;
+    for (LogEventType type : kLogEventTypes) {
+        if (typeMask & (1u << static_cast<uint32_t>(type))) {
+            event.type = type;
+            enqueueEvent(event, line);
+        }
+    }
 }
 
-void VRChatLogHandler::processLine(const std::string& line) {
-    if (!callback_) {
+void VRChatLogHandler::enqueueEvent(const LogEvent& event, std::string_view line) {
+    if (!eventQueue_.tryPushWith([&](LogEventSlot& slot) { slot.assign(event, line); })) {
+        uint64_t dropped = eventsDropped_.fetch_add(1, std::memory_order_relaxed) + 1;
+        std::cerr << "[LogQueue] queue full (capacity=" << eventQueue_.capacity()
+                  << "), dropped=" << dropped << std::endl;
         return;
     }
 
-    try {
-        if (line.find(FISH_HOOK_KEYWORD) != std::string::npos) {
-            callback_(LogEventType::FishOnHook, line);
-        }
-        if (line.find(FISH_PICKUP_KEYWORD) != std::string::npos) {
-            callback_(LogEventType::FishPickup, line);
+    eventsQueued_.fetch_add(1, std::memory_order_relaxed);
+    size_t depth = eventQueue_.sizeApprox();
+    if (depth > queueHighWater_.load(std::memory_order_relaxed)) {
+        queueHighWater_.store(depth, std::memory_order_relaxed);
+    }
+    SetEvent(eventReadyEvent_);
+}
+
+void VRChatLogHandler::dispatchThread() {
+    auto deliver = [this](LogEventSlot& slot) {
+        try {
+            callback_(slot.view());
+        } catch (...) {
         }
-        if (line.find(BUCKET_SAVE_KEYWORD) != std::string::npos) {
-            callback_(LogEventType::BucketSave, line);
+    };
+    while (running_.load(std::memory_order_acquire)) {
+        while (running_.load(std::memory_order_acquire) && eventQueue_.tryPopWith(deliver)) {
         }
-    } catch (...) {
+        WaitForSingleObject(eventReadyEvent_, INFINITE);
     }
 }
 
-void VRChatLogHandler::processLogContent(const std::string& content) {
+void VRChatLogHandler::processLogContent(std::string_view content, uint64_t fileOffset) {
     if (content.empty()) {
         return;
     }
 
-    std::istringstream stream(content);
-    std::string line;
-    
-    while (std::getline(stream, line)) {
-        if (!line.empty()) {
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
-            }
-            processLine(line);
-        }
-    }
+    forEachLine(content, [&](std::string_view line) {
+        processLine(line, fileOffset + static_cast<uint64_t>(line.data() - content.data()));
+        return true;
+    });
 }
@@ -1,63 +1,97 @@
 #pragma once
+#include "FishingClock.h"
+#include "KeywordMatcher.h"
+#include "LogChangeSource.h"
+#include "LogEvent.h"
+#include "LogEventSlot.h"
+#include "LogReadBuffer.h"
+#include "RecentLogRing.h"
+#include "SpscQueue.h"
 #include <windows.h>
 #include <string>
+#include <memory>
 #include <functional>
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
 
-enum class LogEventType {
-    FishOnHook,
-    FishPickup,
-    BucketSave
+struct LogEventQueueStats {
+    size_t depth;
+    size_t highWater;
+    size_t capacity;
+    uint64_t queued;
+    uint64_t dropped;
 };
 
 class VRChatLogHandler {
 public:
-    static constexpr const char* FISH_HOOK_KEYWORD = "SAVED DATA";
-    static constexpr const char* FISH_PICKUP_KEYWORD = "Fish Pickup attached to rod Toggles(True)";
-    static constexpr const char* BUCKET_SAVE_KEYWORD = "Attempt saving";
+    static constexpr const char* FISH_HOOK_KEYWORD = kFishHookKeyword;
+    static constexpr const char* FISH_PICKUP_KEYWORD = kFishPickupKeyword;
+    static constexpr const char* BUCKET_SAVE_KEYWORD = kBucketSaveKeyword;
     static constexpr const char* LOG_FILE_PREFIX = "output_log_";
     static constexpr const char* LOG_FILE_EXTENSION = ".txt";
 
-    using LogCallback = std::function<void(LogEventType, const std::string&)>;
+    using LogCallback = std::function<void(const LogEvent&)>;
 
-    explicit VRChatLogHandler(LogCallback callback);
+    // observedAt on every event is read from clock
+    VRChatLogHandler(FishingClock& clock, LogCallback callback);
     ~VRChatLogHandler();
 
     VRChatLogHandler(const VRChatLogHandler&) = delete;
     VRChatLogHandler& operator=(const VRChatLogHandler&) = delete;
 
+    // Register an extra keyword for an event type; only valid before startMonitor()
+    bool addKeyword(std::string_view keyword, LogEventType type);
+
     void startMonitor();
     void stop();
-    std::string safeReadFile();
-    std::string readTail(size_t maxBytes = 131072);
+
+    // Query the ring of recently ingested keyword lines; see RecentLogRing::findSince
+    bool findRecentEvent(LogEventType type, std::chrono::system_clock::time_point minTime, uint64_t& cursor) const;
+
     std::string getCurrentLogPath() const;
+    LogEventQueueStats getEventQueueStats() const;
     bool isRunning() const noexcept { return running_.load(std::memory_order_acquire); }
 
 private:
     std::wstring getVRChatLogDir() const;
     std::wstring findLatestLog() const;
     bool updateLogFile();
-    void directoryWatchThread();
     void fileReadThread();
-    std::string readNewContent();
-    void processLogContent(const std::string& content);
-    void processLine(const std::string& line);
+    void dispatchThread();
+    bool readNewContent(std::string_view& completeLines, uint64_t& fileOffset);
+    void drainLogFile();
+    void processLogContent(std::string_view content, uint64_t fileOffset);
+    void processLine(std::string_view line, uint64_t fileOffset);
+    void enqueueEvent(const LogEvent& event, std::string_view line);
 
+    FishingClock& clock_;
     LogCallback callback_;
+    KeywordMatcher matcher_;
+    std::array<KeywordMatcher::Mask, kLogEventTypeCount> typeMasks_{};
+    RecentLogRing recentEvents_;
     std::wstring logDirectory_;
     std::wstring currentLogPath_;
     LARGE_INTEGER filePosition_;
-    std::string incompleteLineBuffer_;
+    LogReadBuffer readBuffer_;
     
     std::atomic<bool> running_;
     mutable std::mutex mutex_;
     
-    HANDLE stopEvent_;
-    HANDLE fileChangeEvent_;
+    std::unique_ptr<LogChangeSource> changeSource_;
     HANDLE logFileHandle_;
-    
-    std::thread watchThread_;
+
+    // Reader thread produces, dispatcher thread consumes and runs callback_
+    SpscQueue<LogEventSlot> eventQueue_;
+    HANDLE eventReadyEvent_;
+    std::atomic<uint64_t> eventsQueued_;
+    std::atomic<uint64_t> eventsDropped_;
+    std::atomic<size_t> queueHighWater_;
+
     std::thread readThread_;
+    std::thread dispatchThread_;
 };
@@ -119,7 +119,7 @@ BOOL InitInstance(HINSTANCE hInstance, int nCmdShow)
 
    HWND hWnd = CreateWindowW(szWindowClass, windowTitle.c_str(),
       WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX,
-      CW_USEDEFAULT, 0, 480, 560, nullptr, nullptr, hInstance, nullptr);
+      CW_USEDEFAULT, 0, 480, 675, nullptr, nullptr, hInstance, nullptr);
 
    if (!hWnd)
    {
@@ -0,0 +1,162 @@
+// Jitter benchmark of the cast hold: how late the release lands after a hold
+// of --hold seconds, for each way the cycle can time it.
+//
+//   sleep_for       the thread that pressed sleeps, then releases
+//   timer + actor   a TimerScheduler callback posts to a waiting thread that
+//                   releases, as the cycle's actor does with CastTiming::Timer
+//   precise         PreciseTimer releases from its own thread
+//                   (CastTiming::Precise)
+//
+// Variants alternate hold by hold so that load and frequency scaling hit all
+// of them alike. --load starts that many threads spinning on a core each, to
+// see how the spin in PreciseTimer holds up when the machine is busy.
+//
+//   hold_bench [--hold S] [--holds N] [--load N] [--margin MS]
+
+#include "FishingClock.h"
+#include "PreciseTimer.h"
+#include "TimerScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    double hold = 0.2;
+    long holds = 50;
+    int load = 0;
+    double marginMs = 20.0;
+};
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--hold") == 0 && hasValue) {
+            options.hold = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--holds") == 0 && hasValue) {
+            options.holds = std::atol(argv[++i]);
+        } else if (std::strcmp(arg, "--load") == 0 && hasValue) {
+            options.load = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--margin") == 0 && hasValue) {
+            options.marginMs = std::atof(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return options.hold > 0.0 && options.holds > 0 && options.load >= 0 && options.marginMs >= 0.0;
+}
+
+// One release handed from the thread that timed it to the one waiting on it
+class Release {
+public:
+    void post(std::chrono::steady_clock::time_point at) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            at_ = at;
+            posted_ = true;
+        }
+        changed_.notify_one();
+    }
+
+    std::chrono::steady_clock::time_point wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this]() { return posted_; });
+        posted_ = false;
+        return at_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::chrono::steady_clock::time_point at_;
+    bool posted_ = false;
+};
+
+double percentile(std::vector<double>& samples, double p) {
+    size_t rank = static_cast<size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+void printRow(const char* name, std::vector<double>& errorsMs) {
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << percentile(errorsMs, 0.50)
+              << std::setw(10) << percentile(errorsMs, 0.90)
+              << std::setw(10) << percentile(errorsMs, 0.99)
+              << std::setw(10) << *std::max_element(errorsMs.begin(), errorsMs.end()) << "\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--hold S] [--holds N] [--load N] [--margin MS]" << std::endl;
+        return 2;
+    }
+
+    std::atomic<bool> loaded{ true };
+    std::vector<std::thread> load;
+    for (int i = 0; i < options.load; ++i) {
+        load.emplace_back([&]() {
+            while (loaded.load(std::memory_order_relaxed)) {
+            }
+        });
+    }
+
+    SystemClock clock;
+    TimerScheduler scheduler(clock);
+    PreciseTimer preciseTimer(clock, std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(options.marginMs)));
+    auto hold = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(options.hold));
+    auto errorMs = [&](std::chrono::steady_clock::time_point pressedAt, std::chrono::steady_clock::time_point releasedAt) {
+        return std::chrono::duration<double, std::milli>(releasedAt - pressedAt - hold).count();
+    };
+
+    std::vector<double> sleepErrors;
+    std::vector<double> timerErrors;
+    std::vector<double> preciseErrors;
+    Release release;
+    for (long i = 0; i < options.holds; ++i) {
+        auto pressedAt = clock.now();
+        std::this_thread::sleep_for(hold);
+        sleepErrors.push_back(errorMs(pressedAt, clock.now()));
+
+        // The actor releases when the timer's message reaches it
+        pressedAt = clock.now();
+        scheduler.schedule(hold, [&]() { release.post(clock.now()); });
+        release.wait();
+        timerErrors.push_back(errorMs(pressedAt, clock.now()));
+
+        pressedAt = clock.now();
+        preciseTimer.fireAt(pressedAt + hold, [&]() { release.post(clock.now()); });
+        preciseErrors.push_back(errorMs(pressedAt, release.wait()));
+    }
+
+    preciseTimer.shutdown();
+    scheduler.shutdown();
+    loaded = false;
+    for (std::thread& thread : load) {
+        thread.join();
+    }
+
+    std::cout << "release error after a " << options.hold << "s hold (ms, " << options.holds << " holds each, "
+              << options.load << " busy threads)\n"
+              << "  " << std::left << std::setw(16) << "" << std::right
+              << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+    printRow("sleep_for", sleepErrors);
+    printRow("timer + actor", timerErrors);
+    printRow("precise", preciseErrors);
+    return 0;
+}
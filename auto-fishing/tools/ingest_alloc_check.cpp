@@ -0,0 +1,277 @@
+// Allocation check of steady-state log ingestion. Replaces the global
+// operator new with a counting one, then feeds a synthetic VRChat log through
+// the same steps as VRChatLogHandler: reads of random size into a
+// LogReadBuffer, forEachLine, KeywordMatcher, parseLogTimestamp,
+// RecentLogRing, and the SpscQueue of LogEventSlots drained by a dispatcher
+// thread. Only the file I/O and the Windows event are left out.
+//
+// The log goes through once to warm up (the buffer reaches its working size,
+// the timestamp cache and the queue's slots are touched) and a second time
+// counted. Steady state must allocate nothing. Keyword lines longer than
+// LOG_EVENT_BODY_BYTES check that the slot cuts the body short instead.
+//
+//   ingest_alloc_check [--mb N]
+
+#include "FishingConfig.h"
+#include "KeywordMatcher.h"
+#include "LineSplitter.h"
+#include "LogEvent.h"
+#include "LogEventSlot.h"
+#include "LogReadBuffer.h"
+#include "LogTimestamp.h"
+#include "RecentLogRing.h"
+#include "SpscQueue.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+std::atomic<bool> counting{ false };
+std::atomic<uint64_t> allocations{ 0 };
+
+}
+
+void* operator new(size_t size) {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+struct Options {
+    long mb = 64;
+};
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--mb") == 0 && hasValue) {
+            options.mb = std::atol(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return options.mb > 0;
+}
+
+// A CRLF log whose timestamps advance a few seconds per line, so the
+// timestamp cache moves on to new hours; about one line in a hundred is a
+// keyword line, and one keyword line in fifty overruns LOG_EVENT_BODY_BYTES
+std::string makeLog(size_t bytes, uint64_t& keywordLines) {
+    const char* const keywords[] = { kFishHookKeyword, kFishPickupKeyword, kBucketSaveKeyword };
+    std::mt19937 random(12345);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::string log;
+    log.reserve(bytes + 4096);
+    std::string padding(FishingConfig::LOG_EVENT_BODY_BYTES, 'x');
+    long seconds = 0;
+    keywordLines = 0;
+    char stamp[32];
+    while (log.size() < bytes) {
+        seconds += 1 + percent(random) % 5;
+        std::snprintf(stamp, sizeof(stamp), "2026.03.%02ld %02ld:%02ld:%02ld ",
+                      1 + (seconds / 86400) % 28, (seconds / 3600) % 24, (seconds / 60) % 60, seconds % 60);
+        log += stamp;
+        if (percent(random) == 0) {
+            log += "Log        -  [FishingSystem] ";
+            log += keywords[keywordLines % std::size(keywords)];
+            if (keywordLines % 50 == 0) {
+                log += padding;
+            }
+            keywordLines++;
+        } else {
+            log += "Log        -  [Behaviour] OnPlayerJoined Someone Else";
+        }
+        log += "\r\n";
+    }
+    return log;
+}
+
+// The reader thread's half of VRChatLogHandler
+class Ingest {
+public:
+    Ingest()
+        : recentEvents_(FishingConfig::RECENT_EVENT_CAPACITY)
+        , queue_(FishingConfig::LOG_EVENT_QUEUE_CAPACITY)
+    {
+        const char* const keywords[] = { kFishHookKeyword, kFishPickupKeyword, kBucketSaveKeyword };
+        for (LogEventType type : kLogEventTypes) {
+            int index = matcher_.addPattern(keywords[static_cast<size_t>(type)]);
+            typeMasks_[static_cast<size_t>(type)] = KeywordMatcher::Mask{ 1 } << index;
+        }
+        matcher_.compile();
+    }
+
+    SpscQueue<LogEventSlot>& queue() { return queue_; }
+    uint64_t queued() const { return queued_; }
+
+    // Reads log in pieces of random size, as the file grows between wakeups
+    void run(std::string_view log, std::mt19937& random) {
+        std::uniform_int_distribution<size_t> readSize(1, FishingConfig::LOG_READ_CHUNK_BYTES);
+        size_t position = 0;
+        uint64_t filePosition = 0;
+        while (position < log.size()) {
+            size_t bytes = std::min(readSize(random), log.size() - position);
+            if (buffer_.size() > FishingConfig::LOG_MAX_LINE_BYTES) {
+                buffer_.clear();
+            }
+            char* target = buffer_.prepare(bytes);
+            std::memcpy(target, log.data() + position, bytes);
+            buffer_.commit(bytes);
+            position += bytes;
+            filePosition += bytes;
+
+            std::string_view lines = buffer_.completeLines();
+            uint64_t fileOffset = filePosition - buffer_.size();
+            forEachLine(lines, [&](std::string_view line) {
+                processLine(line, fileOffset + static_cast<uint64_t>(line.data() - lines.data()));
+                return true;
+            });
+            buffer_.consume(lines.size());
+        }
+    }
+
+private:
+    void processLine(std::string_view line, uint64_t fileOffset) {
+        KeywordMatcher::Mask hits = matcher_.scan(line);
+        if (hits == 0) {
+            return;
+        }
+        uint32_t typeMask = 0;
+        for (LogEventType type : kLogEventTypes) {
+            if (hits & typeMasks_[static_cast<size_t>(type)]) {
+                typeMask |= 1u << static_cast<uint32_t>(type);
+            }
+        }
+
+        LogEvent event{};
+        event.timestamp = parseLogTimestamp(line);
+        event.observedAt = std::chrono::steady_clock::now();
+        event.fileOffset = fileOffset;
+        recentEvents_.push(typeMask, event.timestamp);
+
+        for (LogEventType type : kLogEventTypes) {
+            if (typeMask & (1u << static_cast<uint32_t>(type))) {
+                event.type = type;
+                // VRChatLogHandler drops the event when full; here every one must arrive
+                while (!queue_.tryPushWith([&](LogEventSlot& slot) { slot.assign(event, line); })) {
+                    std::this_thread::yield();
+                }
+                queued_++;
+            }
+        }
+    }
+
+    LogReadBuffer buffer_;
+    KeywordMatcher matcher_;
+    std::array<KeywordMatcher::Mask, kLogEventTypeCount> typeMasks_{};
+    RecentLogRing recentEvents_;
+    SpscQueue<LogEventSlot> queue_;
+    uint64_t queued_ = 0;
+};
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--mb N]" << std::endl;
+        return 2;
+    }
+
+    uint64_t keywordLines = 0;
+    std::string log = makeLog(static_cast<size_t>(options.mb) * 1024 * 1024, keywordLines);
+    Ingest ingest;
+
+    // The dispatcher thread's half; checks each body as the callback would see it
+    std::atomic<bool> ingesting{ true };
+    std::atomic<uint64_t> delivered{ 0 };
+    std::atomic<uint64_t> badBodies{ 0 };
+    std::atomic<uint64_t> truncated{ 0 };
+    std::thread dispatcher([&]() {
+        auto deliver = [&](LogEventSlot& slot) {
+            const LogEvent& event = slot.view();
+            if (!event.timestamp || event.body.size() > FishingConfig::LOG_EVENT_BODY_BYTES
+                || event.body.substr(0, 5) != "2026.") {
+                badBodies.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (event.body.size() == FishingConfig::LOG_EVENT_BODY_BYTES) {
+                truncated.fetch_add(1, std::memory_order_relaxed);
+            }
+            delivered.fetch_add(1, std::memory_order_relaxed);
+        };
+        while (true) {
+            bool more = ingesting.load(std::memory_order_acquire);
+            while (ingest.queue().tryPopWith(deliver)) {
+            }
+            if (!more) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+    });
+
+    std::mt19937 random(6789);
+    ingest.run(log, random);
+    uint64_t warmupQueued = ingest.queued();
+
+    counting = true;
+    auto startedAt = std::chrono::steady_clock::now();
+    ingest.run(log, random);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+    counting = false;
+
+    ingesting = false;
+    dispatcher.join();
+
+    uint64_t counted = allocations.load();
+    uint64_t events = ingest.queued() - warmupQueued;
+    bool ok = counted == 0 && delivered == ingest.queued() && events == keywordLines && badBodies == 0
+        && truncated == 2 * ((keywordLines + 49) / 50);
+    std::cout << "log:          " << log.size() / (1024 * 1024) << " MB, " << keywordLines << " keyword lines\n"
+              << "counted pass: " << events << " events in " << seconds << "s\n"
+              << "delivered:    " << delivered << " of " << ingest.queued() << " (both passes), "
+              << truncated << " bodies cut at " << FishingConfig::LOG_EVENT_BODY_BYTES << " bytes, "
+              << badBodies << " bad\n"
+              << "allocations:  " << counted << "\n"
+              << (ok ? "OK" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+// Throughput benchmark of keyword matching: a synthetic VRChat log of --mb
+// megabytes, split into lines, scanned by one std::string_view::find per
+// keyword (what processLine did before KeywordMatcher) and by a compiled
+// KeywordMatcher. Runs once with the three built-in keywords and once with
+// --extra more, to show how each path scales with the keyword count.
+//
+// Both paths see the same lines and must report the same number of hits.
+// Variants alternate round by round; the best round of each is reported.
+//
+//   keyword_bench [--mb N] [--rounds N] [--extra N]
+
+#include "KeywordMatcher.h"
+#include "LineSplitter.h"
+#include "LogEvent.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Lines in the proportions of a busy instance: mostly chatter, a bite now and then
+const char* const kChatter[] = {
+    "2026.10.17 21:14:03 Log        -  [Behaviour] OnPlayerJoined Someone Else",
+    "2026.10.17 21:14:03 Log        -  [Network Processing] RPC invoked ProcessEvent on Pickup (Clone)",
+    "2026.10.17 21:14:04 Warning    -  [AvatarDescriptor] Avatar has too many PhysBones, some were disabled.",
+    "2026.10.17 21:14:04 Log        -  [Always] uSpeak: SetInputDevice 0 (3 total) 'Microphone (USB Audio Device)'",
+    "2026.10.17 21:14:05 Log        -  [Video Playback] Attempting to resolve URL 'https://example.com/stream'",
+    "2026.10.17 21:14:05 Error      -  [UdonBehaviour] An exception occurred during Udon execution, this UdonBehaviour will be halted.",
+    "2026.10.17 21:14:06 Log        -  [API] Fetching world information for wrld_00000000-0000-0000-0000-000000000000",
+    "2026.10.17 21:14:06 Log        -  [Behaviour] Switching Someone Else to avatar Fishing Outfit",
+};
+
+const char* const kKeywordLines[] = {
+    "2026.10.17 21:14:07 Log        -  [FishingSystem] SAVED DATA for rod 1",
+    "2026.10.17 21:14:08 Log        -  [FishingSystem] Fish Pickup attached to rod Toggles(True)",
+    "2026.10.17 21:14:09 Log        -  [FishingSystem] Attempt saving bucket contents",
+};
+
+// Further keywords a world might register through addKeyword()
+const char* const kExtraKeywords[] = {
+    "OnPlayerLeft", "Fish Pickup attached to rod Toggles(False)", "Joining wrld_", "[Video Playback] ERROR",
+    "Rod broke", "Reel tension", "Bait consumed", "Rare fish", "Bucket full", "Achievement unlocked",
+    "Leaderboard updated", "Weather changed", "Night started", "Day started", "Fishing spot moved",
+    "Sell fish", "Shop purchase", "Rod upgraded",
+};
+constexpr size_t kExtraKeywordCount = sizeof(kExtraKeywords) / sizeof(kExtraKeywords[0]);
+
+struct Options {
+    long mb = 500;
+    int rounds = 3;
+    size_t extra = 8;
+};
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--mb") == 0 && hasValue) {
+            options.mb = std::atol(argv[++i]);
+        } else if (std::strcmp(arg, "--rounds") == 0 && hasValue) {
+            options.rounds = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--extra") == 0 && hasValue) {
+            options.extra = static_cast<size_t>(std::atol(argv[++i]));
+        } else {
+            return false;
+        }
+    }
+    return options.mb > 0 && options.rounds > 0 && options.extra <= kExtraKeywordCount;
+}
+
+std::string makeLog(size_t bytes) {
+    std::mt19937 random(12345);
+    std::uniform_int_distribution<size_t> chatter(0, std::size(kChatter) - 1);
+    std::uniform_int_distribution<int> perMille(0, 999);
+    std::string log;
+    log.reserve(bytes + 256);
+    size_t keyword = 0;
+    while (log.size() < bytes) {
+        if (perMille(random) == 0) {
+            log += kKeywordLines[keyword++ % std::size(kKeywordLines)];
+        } else {
+            log += kChatter[chatter(random)];
+        }
+        log += "\r\n";
+    }
+    return log;
+}
+
+// Keeps the compiler from discarding a scan whose result is unused
+std::atomic<uint64_t> sink{ 0 };
+
+uint64_t scanWithFind(std::string_view log, const std::vector<std::string>& keywords) {
+    uint64_t hits = 0;
+    forEachLine(log, [&](std::string_view line) {
+        for (const std::string& keyword : keywords) {
+            if (line.find(keyword) != std::string_view::npos) {
+                hits++;
+            }
+        }
+        return true;
+    });
+    return hits;
+}
+
+uint64_t scanWithMatcher(std::string_view log, const KeywordMatcher& matcher) {
+    uint64_t hits = 0;
+    forEachLine(log, [&](std::string_view line) {
+        KeywordMatcher::Mask mask = matcher.scan(line);
+        if (mask != 0) {
+            hits += static_cast<uint64_t>(std::popcount(mask));
+        }
+        return true;
+    });
+    return hits;
+}
+
+struct Row {
+    const char* name;
+    double bestSeconds = 1e30;
+    uint64_t hits = 0;
+};
+
+template <typename Scan>
+void timeRound(Row& row, Scan&& scan) {
+    auto t0 = std::chrono::steady_clock::now();
+    row.hits = scan();
+    auto t1 = std::chrono::steady_clock::now();
+    sink.fetch_add(row.hits, std::memory_order_relaxed);
+    row.bestSeconds = std::min(row.bestSeconds, std::chrono::duration<double>(t1 - t0).count());
+}
+
+bool compare(std::string_view log, const std::vector<std::string>& keywords, int rounds) {
+    KeywordMatcher matcher;
+    for (const std::string& keyword : keywords) {
+        matcher.addPattern(keyword);
+    }
+    matcher.compile();
+
+    Row find{ "find per keyword" };
+    Row automaton{ "KeywordMatcher" };
+    for (int round = 0; round < rounds; ++round) {
+        timeRound(find, [&]() { return scanWithFind(log, keywords); });
+        timeRound(automaton, [&]() { return scanWithMatcher(log, matcher); });
+    }
+
+    double mb = log.size() / (1024.0 * 1024.0);
+    std::cout << keywords.size() << " keywords\n";
+    for (const Row& row : { find, automaton }) {
+        std::cout << "  " << std::left << std::setw(18) << row.name << std::right << std::fixed
+                  << std::setprecision(0) << std::setw(8) << mb / row.bestSeconds << " MB/s"
+                  << std::setw(10) << row.hits << " hits\n";
+    }
+    return find.hits == automaton.hits;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--mb N] [--rounds N] [--extra N]" << std::endl;
+        return 2;
+    }
+
+    std::string log = makeLog(static_cast<size_t>(options.mb) * 1024 * 1024);
+    std::cout << "synthetic log: " << log.size() / (1024 * 1024) << " MB, best of "
+              << options.rounds << " rounds\n";
+
+    std::vector<std::string> keywords = { kFishHookKeyword, kFishPickupKeyword, kBucketSaveKeyword };
+    bool ok = compare(log, keywords, options.rounds);
+    if (options.extra > 0) {
+        keywords.insert(keywords.end(), kExtraKeywords, kExtraKeywords + options.extra);
+        ok = compare(log, keywords, options.rounds) && ok;
+    }
+    std::cout << (ok ? "OK" : "MISMATCH") << std::endl;
+    return ok ? 0 : 1;
+}
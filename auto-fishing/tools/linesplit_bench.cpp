@@ -0,0 +1,184 @@
+// Microbenchmark of log line splitting over a synthetic VRChat log of --mb
+// megabytes: the istringstream + getline copy per line that processLogContent
+// did before LineSplitter, then forEachLine's loop over each newline kernel:
+//
+//   byte loop   compares one byte at a time
+//   memchr      NewlineKernel::Scalar, the fallback without SSE2
+//   sse2        16 bytes per compare
+//   avx2        32 bytes per compare, picked at runtime when the CPU has it
+//
+// Every variant must find the same lines and bytes. Variants alternate round
+// by round; the best round of each is reported.
+//
+//   linesplit_bench [--mb N] [--rounds N]
+
+#include "LineSplitter.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const char* const kLines[] = {
+    "2026.10.17 21:14:03 Log        -  [Behaviour] OnPlayerJoined Someone Else",
+    "2026.10.17 21:14:03 Log        -  [Network Processing] RPC invoked ProcessEvent on Pickup (Clone)",
+    "2026.10.17 21:14:04 Warning    -  [AvatarDescriptor] Avatar has too many PhysBones, some were disabled.",
+    "2026.10.17 21:14:05 Error      -  [UdonBehaviour] An exception occurred during Udon execution, this UdonBehaviour will be halted.",
+    "2026.10.17 21:14:06 Log        -  [API] Fetching world information for wrld_00000000-0000-0000-0000-000000000000",
+    "2026.10.17 21:14:07 Log        -  [FishingSystem] SAVED DATA for rod 1",
+    "2026.10.17 21:14:08 Log        -  [Always] Unload",
+};
+
+struct Options {
+    long mb = 200;
+    int rounds = 3;
+};
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--mb") == 0 && hasValue) {
+            options.mb = std::atol(argv[++i]);
+        } else if (std::strcmp(arg, "--rounds") == 0 && hasValue) {
+            options.rounds = std::atoi(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return options.mb > 0 && options.rounds > 0;
+}
+
+// VRChat writes CRLF
+std::string makeLog(size_t bytes) {
+    std::mt19937 random(12345);
+    std::uniform_int_distribution<size_t> pick(0, std::size(kLines) - 1);
+    std::string log;
+    log.reserve(bytes + 256);
+    while (log.size() < bytes) {
+        log += kLines[pick(random)];
+        log += "\r\n";
+    }
+    return log;
+}
+
+const char* findNewlineByteLoop(const char* p, const char* end) noexcept {
+    while (p < end && *p != '\n') {
+        ++p;
+    }
+    return p;
+}
+
+struct Count {
+    uint64_t lines = 0;
+    uint64_t bytes = 0;
+};
+
+Count splitWithGetline(const std::string& log) {
+    Count count;
+    std::istringstream stream(log);
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            count.lines++;
+            count.bytes += line.size();
+        }
+    }
+    return count;
+}
+
+// forEachLine with the kernel passed in rather than picked by findNewline()
+Count splitWithKernel(std::string_view text, FindNewlineFn kernel) {
+    Count count;
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        const char* newline = kernel(p, end);
+        const char* lineEnd = newline;
+        if (lineEnd > p && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        if (lineEnd > p) {
+            count.lines++;
+            count.bytes += static_cast<uint64_t>(lineEnd - p);
+        }
+        p = (newline == end) ? end : newline + 1;
+    }
+    return count;
+}
+
+struct Row {
+    const char* name;
+    FindNewlineFn kernel;
+    double bestSeconds = 1e30;
+    Count count{};
+};
+
+// Keeps the compiler from discarding a split whose result is unused
+std::atomic<uint64_t> sink{ 0 };
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--mb N] [--rounds N]" << std::endl;
+        return 2;
+    }
+
+    std::string log = makeLog(static_cast<size_t>(options.mb) * 1024 * 1024);
+
+    // The first row, with no kernel, is getline
+    std::vector<Row> rows = { Row{ "getline", nullptr } };
+    const std::pair<const char*, FindNewlineFn> kernels[] = {
+        { "byte loop", &findNewlineByteLoop },
+        { "memchr", newlineKernel(NewlineKernel::Scalar) },
+        { "sse2", newlineKernel(NewlineKernel::Sse2) },
+        { "avx2", newlineKernel(NewlineKernel::Avx2) },
+    };
+    for (const auto& [name, kernel] : kernels) {
+        if (kernel) {
+            rows.push_back(Row{ name, kernel });
+        } else {
+            std::cout << name << " is not available on this CPU or build\n";
+        }
+    }
+
+    for (int round = 0; round < options.rounds; ++round) {
+        for (Row& row : rows) {
+            auto t0 = std::chrono::steady_clock::now();
+            row.count = row.kernel ? splitWithKernel(log, row.kernel) : splitWithGetline(log);
+            auto t1 = std::chrono::steady_clock::now();
+            sink.fetch_add(row.count.lines, std::memory_order_relaxed);
+            row.bestSeconds = std::min(row.bestSeconds, std::chrono::duration<double>(t1 - t0).count());
+        }
+    }
+
+    double mb = log.size() / (1024.0 * 1024.0);
+    const Row& baseline = rows.front();
+    bool ok = true;
+    std::cout << "synthetic log: " << log.size() / (1024 * 1024) << " MB, " << baseline.count.lines
+              << " lines, best of " << options.rounds << " rounds\n";
+    for (const Row& row : rows) {
+        std::cout << "  " << std::left << std::setw(10) << row.name << std::right << std::fixed
+                  << std::setprecision(0) << std::setw(8) << mb / row.bestSeconds << " MB/s"
+                  << std::setprecision(1) << std::setw(8) << baseline.bestSeconds / row.bestSeconds << "x\n";
+        ok = ok && row.count.lines == baseline.count.lines && row.count.bytes == baseline.count.bytes;
+    }
+    std::cout << (ok ? "OK" : "MISMATCH") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+// Latency benchmark of log tailing: a writer appends synthetic VRChat lines to
+// a log file it keeps open, as VRChat does, and two readers time each bite
+// line from write() to the keyword match.
+//
+//   poll    sleeps LOG_CHECK_INTERVAL between reads, as fileReadThread did
+//           before the directory watch
+//   watch   waits on LogChangeSource with LOG_CHECK_INTERVAL as the timeout,
+//           as fileReadThread does now
+//
+// Both read the same lines, at random gaps so that a line can land anywhere in
+// the poll period. --no-notify points the watch at an empty directory, so it
+// only wakes on the timeout: what happens when NTFS defers the notifications
+// for the open log. inotify on Linux; builds on Linux like the other tools.
+//
+//   logwatch_bench [--lines N] [--no-notify]
+
+#include "FishingConfig.h"
+#include "KeywordMatcher.h"
+#include "LineSplitter.h"
+#include "LogChangeSource.h"
+#include "LogEvent.h"
+#include "LogReadBuffer.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    long lines = 40;
+    bool noNotify = false;
+};
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--lines") == 0 && hasValue) {
+            options.lines = std::atol(argv[++i]);
+        } else if (std::strcmp(arg, "--no-notify") == 0) {
+            options.noNotify = true;
+        } else {
+            return false;
+        }
+    }
+    return options.lines > 0;
+}
+
+int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double percentile(std::vector<double>& samples, double p) {
+    size_t rank = static_cast<size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+// Tails path like fileReadThread and drainLogFile, and stamps each bite line
+// with the time it was matched
+class Reader {
+public:
+    Reader(const std::filesystem::path& path, long lines)
+        : detectedAt_(new std::atomic<int64_t>[lines])
+        , lines_(lines)
+    {
+        for (long i = 0; i < lines; ++i) {
+            detectedAt_[i].store(0, std::memory_order_relaxed);
+        }
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        matcher_.addPattern(kFishHookKeyword);
+        matcher_.compile();
+    }
+
+    ~Reader() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    void drain() {
+        while (true) {
+            char* target = buffer_.prepare(FishingConfig::LOG_READ_CHUNK_BYTES);
+            ssize_t bytesRead = read(fd_, target, FishingConfig::LOG_READ_CHUNK_BYTES);
+            if (bytesRead <= 0) {
+                return;
+            }
+            buffer_.commit(static_cast<size_t>(bytesRead));
+            std::string_view lines = buffer_.completeLines();
+            forEachLine(lines, [&](std::string_view line) {
+                if (matcher_.scan(line) != 0) {
+                    stamp(line);
+                }
+                return true;
+            });
+            buffer_.consume(lines.size());
+        }
+    }
+
+    int64_t detectedAt(long sequence) const {
+        return detectedAt_[sequence].load(std::memory_order_acquire);
+    }
+
+private:
+    void stamp(std::string_view line) {
+        size_t at = line.rfind("seq=");
+        if (at == std::string_view::npos) {
+            return;
+        }
+        long sequence = std::atol(std::string(line.substr(at + 4)).c_str());
+        if (sequence >= 0 && sequence < lines_) {
+            detectedAt_[sequence].store(nowNanos(), std::memory_order_release);
+        }
+    }
+
+    int fd_ = -1;
+    LogReadBuffer buffer_;
+    KeywordMatcher matcher_;
+    std::unique_ptr<std::atomic<int64_t>[]> detectedAt_;
+    long lines_;
+};
+
+void printRow(const char* name, const Reader& reader, const std::vector<int64_t>& writtenAt, bool& ok) {
+    std::vector<double> ms;
+    for (size_t i = 0; i < writtenAt.size(); ++i) {
+        int64_t detected = reader.detectedAt(static_cast<long>(i));
+        if (detected == 0) {
+            ok = false;
+            continue;
+        }
+        ms.push_back((detected - writtenAt[i]) / 1e6);
+    }
+    std::cout << "  " << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(2);
+    if (ms.empty()) {
+        std::cout << "  no line seen\n";
+        return;
+    }
+    double total = 0.0;
+    for (double value : ms) {
+        total += value;
+    }
+    std::cout << std::setw(10) << total / ms.size()
+              << std::setw(10) << percentile(ms, 0.50)
+              << std::setw(10) << percentile(ms, 0.99)
+              << std::setw(10) << *std::max_element(ms.begin(), ms.end())
+              << "   (" << ms.size() << " of " << writtenAt.size() << " lines)\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--lines N] [--no-notify]" << std::endl;
+        return 2;
+    }
+
+    namespace fs = std::filesystem;
+    fs::path directory = fs::temp_directory_path() / ("logwatch_bench_" + std::to_string(getpid()));
+    fs::path quietDirectory = directory / "quiet";
+    fs::path logPath = directory / "output_log_bench.txt";
+    std::error_code error;
+    fs::create_directories(quietDirectory, error);
+    int writer = ::open(logPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (error || writer < 0) {
+        std::cerr << "cannot create " << logPath << std::endl;
+        return 1;
+    }
+
+    Reader polled(logPath, options.lines);
+    Reader watched(logPath, options.lines);
+    std::unique_ptr<LogChangeSource> changeSource = LogChangeSource::create();
+    bool watching = changeSource->open(options.noNotify ? quietDirectory : directory);
+    if (!polled.isOpen() || !watched.isOpen() || !watching) {
+        std::cerr << "cannot open or watch " << logPath << std::endl;
+        return 1;
+    }
+
+    const auto interval = std::chrono::milliseconds(static_cast<int>(FishingConfig::LOG_CHECK_INTERVAL * 1000));
+    std::atomic<bool> running{ true };
+    std::thread pollThread([&]() {
+        while (running.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(interval);
+            polled.drain();
+        }
+    });
+    std::thread watchThread([&]() {
+        while (running.load(std::memory_order_acquire)) {
+            if (changeSource->wait(interval) == LogChangeKind::Stopped) {
+                break;
+            }
+            watched.drain();
+        }
+    });
+
+    // Gaps are not a multiple of the poll period, so lines land all over it
+    std::mt19937 random(12345);
+    std::uniform_int_distribution<int> gapMs(50, 400);
+    std::vector<int64_t> writtenAt(static_cast<size_t>(options.lines));
+    char line[160];
+    for (long i = 0; i < options.lines; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(gapMs(random)));
+        int length = std::snprintf(line, sizeof(line),
+                                   "2026.10.17 12:00:00 Log        -  [Behaviour] Unrelated chatter %ld\n"
+                                   "2026.10.17 12:00:00 Log        -  %s seq=%ld\n",
+                                   i, kFishHookKeyword, i);
+        writtenAt[i] = nowNanos();
+        if (write(writer, line, static_cast<size_t>(length)) != length) {
+            std::cerr << "write failed" << std::endl;
+            break;
+        }
+    }
+
+    // Longest wait either reader can be in, plus slack
+    std::this_thread::sleep_for(interval * 2);
+    running = false;
+    changeSource->interrupt();
+    pollThread.join();
+    watchThread.join();
+    close(writer);
+    fs::remove_all(directory, error);
+
+    bool ok = true;
+    std::cout << "write to keyword match (ms, " << (options.noNotify ? "no notifications" : "inotify")
+              << ", interval " << interval.count() << "ms)\n"
+              << "  " << std::setw(8) << "" << std::setw(10) << "mean" << std::setw(10) << "p50"
+              << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+    printRow("poll", polled, writtenAt, ok);
+    printRow("watch", watched, writtenAt, ok);
+    std::cout << (ok ? "OK" : "MISSED LINES") << std::endl;
+    return ok ? 0 : 1;
+}
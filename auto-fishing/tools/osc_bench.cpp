@@ -0,0 +1,235 @@
+// Microbenchmark of OSC encoding: the click press path with the per-call
+// std::string encoding OSCClient used to do against a packet interned with
+// OscPacket, and OscWriter's throughput on floats, strings and bundles.
+//
+// Each variant is timed both on its own (encode only) and with the sendto to
+// a UDP socket on 127.0.0.1 that a second thread drains, as OSCClient sends to
+// VRChat. Variants alternate in batches so that frequency scaling and other
+// drift hit all of them alike. POSIX sockets; builds on Linux like the other
+// tools.
+//
+//   osc_bench [--iterations N] [--sends N]
+
+#include "OscPacket.h"
+#include "OscWriter.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr const char* kClickAddress = "/input/UseRight";
+constexpr int kBatch = 1000;
+
+// OSCClient::buildOSCMessage as it was before packets were interned
+size_t padTo4Bytes(size_t size) {
+    return (size + 3) & ~3;
+}
+
+std::string buildOSCMessage(const std::string& address, int value) {
+    std::string message;
+    message += address;
+    size_t addressPadded = padTo4Bytes(address.length() + 1);
+    message.append(addressPadded - address.length(), '\0');
+    message += ",i";
+    message.append(2, '\0');
+    unsigned char valueBytes[4];
+    valueBytes[0] = (value >> 24) & 0xFF;
+    valueBytes[1] = (value >> 16) & 0xFF;
+    valueBytes[2] = (value >> 8) & 0xFF;
+    valueBytes[3] = value & 0xFF;
+    message.append(reinterpret_cast<char*>(valueBytes), 4);
+    return message;
+}
+
+struct Options {
+    long iterations = 10000000;
+    long sends = 200000;
+};
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--iterations") == 0 && hasValue) {
+            options.iterations = std::atol(argv[++i]);
+        } else if (std::strcmp(arg, "--sends") == 0 && hasValue) {
+            options.sends = std::atol(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return options.iterations > 0 && options.sends > 0;
+}
+
+// Keeps the compiler from discarding an encoding whose result is unused
+std::atomic<uint64_t> sink{ 0 };
+
+double percentile(std::vector<double>& samples, double p) {
+    size_t rank = static_cast<size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+// Times encode() writing one packet over and over into a stack buffer
+template <typename Encode>
+void benchWriter(const char* name, long iterations, Encode encode) {
+    std::array<char, 512> buffer;
+    OscWriter writer(buffer);
+    size_t bytes = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        writer.reset();
+        encode(writer, static_cast<int>(i));
+        bytes = writer.size();
+        sink.fetch_add(static_cast<unsigned char>(writer.data()[bytes - 1]), std::memory_order_relaxed);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8) << bytes << std::setw(10) << ns / iterations
+              << std::setw(10) << std::setprecision(0) << bytes * iterations / ns * 1000.0 << "\n";
+}
+
+void printRow(const char* name, std::vector<double>& ns) {
+    double total = 0.0;
+    for (double value : ns) {
+        total += value;
+    }
+    std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(10) << total / ns.size()
+              << std::setw(10) << percentile(ns, 0.50)
+              << std::setw(10) << percentile(ns, 0.99)
+              << std::setw(10) << percentile(ns, 0.999) << "\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--iterations N] [--sends N]" << std::endl;
+        return 2;
+    }
+
+    const std::string address = kClickAddress;
+    const OscPacket interned = *OscPacket::message(address, 1);
+    if (buildOSCMessage(address, 1) != std::string(interned.data(), interned.size())) {
+        std::cerr << "encodings differ" << std::endl;
+        return 1;
+    }
+
+    // Encode only, timed per batch of kBatch calls
+    std::cout << "encode (ns/op, " << options.iterations << " ops)\n";
+    double legacyNs = 0.0;
+    double packetNs = 0.0;
+    for (long done = 0; done < options.iterations; done += kBatch) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < kBatch; ++i) {
+            std::string message = buildOSCMessage(address, i & 1);
+            sink.fetch_add(static_cast<unsigned char>(message[message.size() - 1]), std::memory_order_relaxed);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        for (int i = 0; i < kBatch; ++i) {
+            std::optional<OscPacket> packet = OscPacket::message(address, i & 1);
+            sink.fetch_add(static_cast<unsigned char>(packet->data()[packet->size() - 1]), std::memory_order_relaxed);
+        }
+        auto t2 = std::chrono::steady_clock::now();
+        legacyNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+        packetNs += std::chrono::duration<double, std::nano>(t2 - t1).count();
+    }
+    std::cout << std::fixed << std::setprecision(1)
+              << "  std::string per call  " << legacyNs / options.iterations << "\n"
+              << "  OscPacket per call    " << packetNs / options.iterations << "\n"
+              << "  interned              0 (encoded once)\n";
+
+    std::cout << "OscWriter (" << options.iterations << " packets each)\n"
+              << "  " << std::left << std::setw(22) << "" << std::right
+              << std::setw(8) << "bytes" << std::setw(10) << "ns/op" << std::setw(10) << "MB/s" << "\n";
+    benchWriter("int click", options.iterations, [&](OscWriter& writer, int i) {
+        writer.message(address, i & 1);
+    });
+    benchWriter("float + bool param", options.iterations, [](OscWriter& writer, int i) {
+        writer.message("/avatar/parameters/FishingRod", static_cast<float>(i & 255) / 255.0f, (i & 1) != 0);
+    });
+    benchWriter("chatbox string", options.iterations, [](OscWriter& writer, int i) {
+        writer.message("/chatbox/input", "Caught another fish, that makes a full bucket", true, (i & 1) != 0);
+    });
+    benchWriter("bundle of 4 params", options.iterations, [](OscWriter& writer, int i) {
+        float value = static_cast<float>(i & 255) / 255.0f;
+        writer.beginBundle();
+        writer.message("/avatar/parameters/RodX", value);
+        writer.message("/avatar/parameters/RodY", value);
+        writer.message("/avatar/parameters/RodZ", value);
+        writer.message("/avatar/parameters/Reeling", i & 1);
+        writer.endBundle();
+    });
+
+    int receiver = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    int sender = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = 0;
+    inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+    socklen_t targetSize = sizeof(target);
+    if (receiver < 0 || sender < 0 || bind(receiver, (sockaddr*)&target, sizeof(target)) != 0
+        || getsockname(receiver, (sockaddr*)&target, &targetSize) != 0) {
+        std::cerr << "cannot open a local UDP socket" << std::endl;
+        return 1;
+    }
+
+    std::atomic<bool> draining{ true };
+    std::thread drain([&]() {
+        char buffer[256];
+        timeval timeout{ 0, 100000 };
+        setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        while (draining.load(std::memory_order_relaxed)) {
+            recv(receiver, buffer, sizeof(buffer), 0);
+        }
+    });
+
+    // Press path: encode (or not) and sendto, timed per call
+    std::vector<double> legacySend;
+    std::vector<double> internedSend;
+    legacySend.reserve(options.sends);
+    internedSend.reserve(options.sends);
+    for (long done = 0; done < options.sends; done += kBatch) {
+        for (int i = 0; i < kBatch; ++i) {
+            auto t0 = std::chrono::steady_clock::now();
+            std::string message = buildOSCMessage(address, 1);
+            sendto(sender, message.c_str(), message.length(), 0, (sockaddr*)&target, sizeof(target));
+            auto t1 = std::chrono::steady_clock::now();
+            legacySend.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+        for (int i = 0; i < kBatch; ++i) {
+            auto t0 = std::chrono::steady_clock::now();
+            sendto(sender, interned.data(), interned.size(), 0, (sockaddr*)&target, sizeof(target));
+            auto t1 = std::chrono::steady_clock::now();
+            internedSend.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+    }
+    draining = false;
+    drain.join();
+    close(sender);
+    close(receiver);
+
+    std::cout << "press path to 127.0.0.1 (ns, " << options.sends << " sends each)\n"
+              << "  " << std::left << std::setw(22) << "" << std::right
+              << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9" << "\n";
+    printRow("std::string + sendto", legacySend);
+    printRow("interned + sendto", internedSend);
+    return 0;
+}
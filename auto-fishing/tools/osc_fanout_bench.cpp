@@ -0,0 +1,205 @@
+// Benchmark of OSC fan-out to several VRChat clients: one click packet sent
+// to --targets local UDP ports, by a sendto() per destination (what Windows
+// does) against OscTransport's single sendmmsg(). Both alternate in batches
+// over the same receivers, which a second thread drains and counts.
+//
+// --failing puts a destination that refuses every datagram (the broadcast
+// address, without SO_BROADCAST) in the middle of the list, to check that a
+// failure is charged to that target alone and the rest still get the packet.
+// POSIX sockets; builds on Linux like the other tools.
+//
+//   osc_fanout_bench [--targets N] [--sends N] [--failing]
+
+#include "OscPacket.h"
+#include "OscTransport.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kBatch = 100;
+
+struct Options {
+    size_t targets = 16;
+    long sends = 20000;
+    bool failing = false;
+};
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--targets") == 0 && hasValue) {
+            options.targets = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (std::strcmp(arg, "--sends") == 0 && hasValue) {
+            options.sends = std::atol(argv[++i]);
+        } else if (std::strcmp(arg, "--failing") == 0) {
+            options.failing = true;
+        } else {
+            return false;
+        }
+    }
+    size_t slots = options.targets + (options.failing ? 1 : 0);
+    return options.targets > 0 && slots <= OscTransport::MAX_TARGETS && options.sends > 0;
+}
+
+double percentile(std::vector<double>& samples, double p) {
+    size_t rank = static_cast<size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+void printRow(const char* name, std::vector<double>& ns) {
+    double total = 0.0;
+    for (double value : ns) {
+        total += value;
+    }
+    std::cout << "  " << std::left << std::setw(18) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(10) << total / ns.size()
+              << std::setw(10) << percentile(ns, 0.50)
+              << std::setw(10) << percentile(ns, 0.99) << "\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--targets N] [--sends N] [--failing]" << std::endl;
+        return 2;
+    }
+
+    // One receiver per VRChat client
+    std::vector<int> receivers;
+    std::vector<sockaddr_in> addresses;
+    for (size_t i = 0; i < options.targets; ++i) {
+        int receiver = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        socklen_t size = sizeof(address);
+        int receiveBuffer = 4 * 1024 * 1024;
+        if (receiver < 0 || bind(receiver, (sockaddr*)&address, sizeof(address)) != 0
+            || getsockname(receiver, (sockaddr*)&address, &size) != 0) {
+            std::cerr << "cannot open a local UDP socket" << std::endl;
+            return 1;
+        }
+        setsockopt(receiver, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+        receivers.push_back(receiver);
+        addresses.push_back(address);
+    }
+
+    OscTransport transport;
+    size_t failingTarget = OscTransport::INVALID_TARGET;
+    for (size_t i = 0; i < options.targets; ++i) {
+        if (options.failing && i == options.targets / 2) {
+            failingTarget = transport.addTarget("255.255.255.255", 9000);
+        }
+        transport.addTarget("127.0.0.1", ntohs(addresses[i].sin_port));
+    }
+    int sender = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (!transport.isOpen() || sender < 0) {
+        std::cerr << "cannot open a UDP socket" << std::endl;
+        return 1;
+    }
+
+    std::vector<uint64_t> received(options.targets, 0);
+    std::atomic<bool> draining{ true };
+    std::thread drain([&]() {
+        std::vector<pollfd> readable(options.targets);
+        char buffer[256];
+        while (true) {
+            for (size_t i = 0; i < options.targets; ++i) {
+                readable[i] = pollfd{ receivers[i], POLLIN, 0 };
+            }
+            int ready = poll(readable.data(), readable.size(), 100);
+            if (ready == 0 && !draining) {
+                return;
+            }
+            for (size_t i = 0; i < options.targets; ++i) {
+                while ((readable[i].revents & POLLIN) && recv(receivers[i], buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {
+                    received[i]++;
+                }
+            }
+        }
+    });
+
+    const OscPacket click = *OscPacket::message("/input/UseRight", 1);
+    std::vector<double> loopNs;
+    std::vector<double> batchedNs;
+    loopNs.reserve(options.sends);
+    batchedNs.reserve(options.sends);
+    for (long done = 0; done < options.sends; done += kBatch) {
+        for (int i = 0; i < kBatch; ++i) {
+            auto t0 = std::chrono::steady_clock::now();
+            for (const sockaddr_in& address : addresses) {
+                sendto(sender, click.data(), click.size(), 0, (const sockaddr*)&address, sizeof(address));
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            loopNs.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+        for (int i = 0; i < kBatch; ++i) {
+            auto t0 = std::chrono::steady_clock::now();
+            transport.send(click.data(), click.size());
+            auto t1 = std::chrono::steady_clock::now();
+            batchedNs.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+        // Lets the drain keep up so that counts can be compared
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    draining = false;
+    drain.join();
+    close(sender);
+    for (int receiver : receivers) {
+        close(receiver);
+    }
+
+    std::cout << "one packet to " << options.targets << " targets (ns, "
+              << loopNs.size() << " sends each)\n"
+              << "  " << std::left << std::setw(18) << "" << std::right
+              << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p99" << "\n";
+    printRow("sendto per target", loopNs);
+    printRow("sendmmsg", batchedNs);
+
+    // Every working target took every batched send, and its receiver saw both variants' packets
+    uint64_t sends = static_cast<uint64_t>(loopNs.size());
+    bool ok = true;
+    std::cout << "per target (transport stats / received of " << 2 * sends << ")\n";
+    std::vector<OscTargetStats> targetStats = transport.getStats();
+    size_t receiverIndex = 0;
+    for (size_t target = 0; target < targetStats.size(); ++target) {
+        const OscTargetStats& stats = targetStats[target];
+        std::cout << "  " << std::left << std::setw(22)
+                  << (stats.target.host + ":" + std::to_string(stats.target.port)) << std::right
+                  << " packets=" << stats.packets << " bytes=" << stats.bytes
+                  << " errors=" << stats.errors;
+        if (stats.lastError != 0) {
+            std::cout << " lastError=" << std::strerror(stats.lastError);
+        }
+        if (target == failingTarget) {
+            ok = ok && stats.packets == 0 && stats.errors == sends;
+        } else {
+            ok = ok && stats.packets == sends && stats.errors == 0;
+            std::cout << " received=" << received[receiverIndex];
+            ok = ok && received[receiverIndex] == 2 * sends;
+            receiverIndex++;
+        }
+        std::cout << "\n";
+    }
+    std::cout << (ok ? "OK" : "MISMATCH") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,307 @@
+// Loopback check of OSC input: a sender thread stands in for VRChat and sends
+// avatar parameters to a UDP port on 127.0.0.1, and a receive loop built like
+// OSCServer's (non-blocking socket, wait for readable, drain, dispatch) feeds
+// them to an OscEventDispatcher with bindings like those in config.json.
+//
+// Every cycle sends a parameter nothing is bound to, a bite (twice, as VRChat
+// resends unchanged parameters), a bundle that clears it and raises a pickup
+// through an address pattern, a truncated packet and an argument-less bucket
+// message. Counts the events and malformed packets against what was sent and
+// times each bite from sendto to the dispatcher's callback. POSIX sockets;
+// builds on Linux like the other tools.
+//
+// Before the cycles, checks oscPatternMatches against a table of patterns and
+// times incoming addresses built to make a backtracking matcher blow up
+// (a bound address's prefix, then many '*' and a character that never
+// matches); each must be dispatched within --pattern-bound-ms.
+//
+//   osc_loopback [--cycles N] [--port P] [--pattern-bound-ms MS]
+
+#include "OscEventDispatcher.h"
+#include "OscReader.h"
+#include "OscWriter.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr const char* kHookAddress = "/avatar/parameters/FishOnHook";
+constexpr const char* kPickupAddress = "/avatar/parameters/FishPickup";
+constexpr const char* kBucketAddress = "/avatar/parameters/BucketSaved";
+
+struct Options {
+    long cycles = 10000;
+    int port = 0;
+    double patternBoundMs = 10.0;
+};
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--cycles") == 0 && hasValue) {
+            options.cycles = std::atol(argv[++i]);
+        } else if (std::strcmp(arg, "--port") == 0 && hasValue) {
+            options.port = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--pattern-bound-ms") == 0 && hasValue) {
+            options.patternBoundMs = std::atof(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return options.cycles > 0 && options.port >= 0 && options.port < 65536 && options.patternBoundMs > 0.0;
+}
+
+struct PatternCase {
+    const char* pattern;
+    const char* address;
+    bool matches;
+};
+
+const PatternCase kPatternCases[] = {
+    { "/avatar/parameters/FishOnHook", kHookAddress, true },
+    { "/avatar/parameters/FishOnHoo", kHookAddress, false },
+    { "/avatar/parameters/FishOnHookX", kHookAddress, false },
+    { "/avatar/parameters/*", kHookAddress, true },
+    { "/avatar/parameters/Fish*", kHookAddress, true },
+    { "/avatar/parameters/*Hook", kHookAddress, true },
+    { "/avatar/parameters/*On*", kHookAddress, true },
+    { "/avatar/parameters/**Hook", kHookAddress, true },
+    { "/avatar/parameters/*Pickup", kHookAddress, false },
+    // '*' and '?' stop at '/'
+    { "/avatar/*", kHookAddress, false },
+    { "/*/parameters/FishOnHook", kHookAddress, true },
+    { "/avatar?parameters/FishOnHook", kHookAddress, false },
+    { "/avatar/parameters/FishOnHo?k", kHookAddress, true },
+    { "/avatar/parameters/FishOnHook?", kHookAddress, false },
+    { "/avatar/parameters/[A-Z]ishOnHook", kHookAddress, true },
+    { "/avatar/parameters/[a-z]ishOnHook", kHookAddress, false },
+    { "/avatar/parameters/[!a-z]ishOnHook", kHookAddress, true },
+    { "/avatar/parameters/[!A-Z]ishOnHook", kHookAddress, false },
+    { "/avatar/parameters/Fish[ABO]nHook", kHookAddress, true },
+    { "/avatar/parameters/Fish[-O]nHook", kHookAddress, true },
+    { "/avatar[/]parameters/FishOnHook", kHookAddress, false },
+    { "/avatar/parameters/Fish{OnHook,Pickup}", kHookAddress, true },
+    { "/avatar/parameters/Fish{OnHook,Pickup}", kPickupAddress, true },
+    { "/avatar/parameters/Fish{Caught,Lost}", kHookAddress, false },
+    { "/avatar/parameters/Fish{On,}Hook", kHookAddress, true },
+    { "/avatar/parameters/{Fish,Bucket}*", kBucketAddress, true },
+    // An unclosed '[' takes the rest of the pattern as its set; an unclosed '{' matches nothing
+    { "/avatar/parameters/FishOnHoo[k", kHookAddress, true },
+    { "/avatar/parameters/FishOnHoo[x", kHookAddress, false },
+    { "/avatar/parameters/Fish{OnHook", kHookAddress, false },
+    { "/avatar/parameters/{", kHookAddress, false },
+    { "", kHookAddress, false },
+};
+
+// An incoming address that a bound one's prefix, stars and a stray 'Z' make
+// hard to reject: every way of spreading the name over the stars gets tried
+std::string manyStars(size_t stars) {
+    return "/avatar/parameters/" + std::string(stars, '*') + "Z";
+}
+
+bool checkPatterns(double boundMs) {
+    bool ok = true;
+    size_t failed = 0;
+    for (const PatternCase& test : kPatternCases) {
+        if (oscPatternMatches(test.pattern, test.address) != test.matches) {
+            std::cout << "  \"" << test.pattern << "\" against " << test.address << ": expected "
+                      << (test.matches ? "a match" : "no match") << "\n";
+            failed++;
+        }
+    }
+    std::cout << "patterns:   " << std::size(kPatternCases) - failed << " of " << std::size(kPatternCases) << " cases\n";
+    ok = failed == 0;
+
+    // Alternating stars and letters defeat collapsing the runs
+    std::string alternating = "/avatar/parameters/";
+    for (int i = 0; i < 16; ++i) {
+        alternating += "*F";
+    }
+    alternating += "Z";
+    const std::string inputs[] = { manyStars(14), manyStars(30), manyStars(60000), alternating };
+    OscEventDispatcher dispatcher([](const LogEvent&) {});
+    dispatcher.addBinding(kHookAddress, LogEventType::FishOnHook);
+    dispatcher.addBinding(kPickupAddress, LogEventType::FishPickup);
+    dispatcher.addBinding(kBucketAddress, LogEventType::BucketSave);
+    // The longer the bound name, the more ways there are to spread it over the stars
+    dispatcher.addBinding("/avatar/parameters/FishBiteIndicatorParam", LogEventType::FishOnHook);
+    auto packet = std::make_unique<char[]>(65536);
+    double slowestMs = 0.0;
+    for (const std::string& address : inputs) {
+        OscWriter writer(packet.get(), 65536);
+        writer.message(address, true);
+        auto t0 = std::chrono::steady_clock::now();
+        OscDispatchResult result = dispatcher.dispatch(packet.get(), writer.size(), t0,
+                                                       std::chrono::system_clock::now());
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        slowestMs = std::max(slowestMs, ms);
+        ok = ok && result.messages == 1 && result.events == 0 && !result.malformed && ms <= boundMs;
+    }
+    std::cout << "many stars: slowest dispatch " << std::fixed << std::setprecision(3) << slowestMs
+              << " ms, bound " << boundMs << " ms\n";
+    return ok;
+}
+
+int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double percentile(std::vector<double>& samples, double p) {
+    size_t rank = static_cast<size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--cycles N] [--port P] [--pattern-bound-ms MS]" << std::endl;
+        return 2;
+    }
+    bool patternsOk = checkPatterns(options.patternBoundMs);
+
+    int receiver = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    int sender = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(static_cast<uint16_t>(options.port));
+    inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+    socklen_t targetSize = sizeof(target);
+    int receiveBuffer = 4 * 1024 * 1024;
+    if (receiver < 0 || sender < 0 || bind(receiver, (sockaddr*)&target, sizeof(target)) != 0
+        || getsockname(receiver, (sockaddr*)&target, &targetSize) != 0) {
+        std::cerr << "cannot open a local UDP socket" << std::endl;
+        return 1;
+    }
+    setsockopt(receiver, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+    fcntl(receiver, F_SETFL, O_NONBLOCK);
+
+    // Send time of each cycle's bite, read back when its event comes through
+    std::unique_ptr<std::atomic<int64_t>[]> hookSentAt(new std::atomic<int64_t>[options.cycles]);
+    std::array<uint64_t, kLogEventTypeCount> eventCounts{};
+    std::vector<double> hookLatencyUs;
+    hookLatencyUs.reserve(options.cycles);
+    long hooksSeen = 0;
+    OscEventDispatcher dispatcher([&](const LogEvent& event) {
+        eventCounts[static_cast<size_t>(event.type)]++;
+        if (event.type == LogEventType::FishOnHook && hooksSeen < options.cycles) {
+            int64_t sentAt = hookSentAt[hooksSeen++].load(std::memory_order_acquire);
+            int64_t observedAt = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                event.observedAt.time_since_epoch()).count();
+            hookLatencyUs.push_back((observedAt - sentAt) / 1000.0);
+        }
+    });
+    dispatcher.addBinding(kHookAddress, LogEventType::FishOnHook);
+    dispatcher.addBinding(kPickupAddress, LogEventType::FishPickup);
+    dispatcher.addBinding(kBucketAddress, LogEventType::BucketSave);
+
+    std::atomic<bool> sending{ true };
+    std::thread standIn([&]() {
+        std::array<char, 256> buffer;
+        OscWriter writer(buffer);
+        auto sendPacket = [&](size_t size) {
+            sendto(sender, buffer.data(), size, 0, (sockaddr*)&target, sizeof(target));
+        };
+        for (long i = 0; i < options.cycles; ++i) {
+            writer.reset();
+            writer.message("/avatar/parameters/VelocityX", 0.25f);
+            sendPacket(writer.size());
+
+            writer.reset();
+            writer.message(kHookAddress, true);
+            hookSentAt[i].store(nowNanos(), std::memory_order_release);
+            sendPacket(writer.size());
+            sendPacket(writer.size());
+
+            writer.reset();
+            writer.beginBundle();
+            writer.message(kHookAddress, false);
+            writer.message("/avatar/parameters/Fish{Pickup,Caught}", 1);
+            writer.endBundle();
+            sendPacket(writer.size());
+
+            writer.reset();
+            writer.message(kPickupAddress, 0.0f);
+            sendPacket(writer.size());
+            // Cut off inside the argument
+            sendPacket(writer.size() - 4);
+
+            writer.reset();
+            writer.message(kBucketAddress);
+            sendPacket(writer.size());
+
+            // Roughly VRChat's pace for a busy avatar, and no faster than the receiver drains
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        sending = false;
+    });
+
+    auto buffer = std::make_unique<char[]>(65536);
+    uint64_t packets = 0;
+    uint64_t malformed = 0;
+    auto startedAt = std::chrono::steady_clock::now();
+    while (true) {
+        pollfd readable{ receiver, POLLIN, 0 };
+        int ready = poll(&readable, 1, 100);
+        if (ready == 0 && !sending) {
+            break;
+        }
+        while (true) {
+            ssize_t received = recvfrom(receiver, buffer.get(), 65536, 0, nullptr, nullptr);
+            if (received < 0) {
+                break;
+            }
+            packets++;
+            OscDispatchResult result = dispatcher.dispatch(buffer.get(), static_cast<size_t>(received),
+                                                           std::chrono::steady_clock::now(),
+                                                           std::chrono::system_clock::now());
+            if (result.malformed) {
+                malformed++;
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+    standIn.join();
+    close(sender);
+    close(receiver);
+
+    uint64_t expected = static_cast<uint64_t>(options.cycles);
+    std::cout << "cycles:     " << options.cycles << " in " << std::fixed << std::setprecision(2) << seconds << "s\n"
+              << "packets:    " << packets << " of " << expected * 7 << "\n";
+    bool ok = packets == expected * 7 && malformed == expected;
+    for (size_t i = 0; i < kLogEventTypeCount; ++i) {
+        std::cout << "  " << std::left << std::setw(11) << kLogEventTypeNames[i] << std::right
+                  << eventCounts[i] << " of " << expected << "\n";
+        ok = ok && eventCounts[i] == expected;
+    }
+    std::cout << "malformed:  " << malformed << " of " << expected << "\n";
+    if (!hookLatencyUs.empty()) {
+        std::cout << "bite sendto to event (us): p50=" << std::setprecision(1) << percentile(hookLatencyUs, 0.50)
+                  << " p99=" << percentile(hookLatencyUs, 0.99)
+                  << " max=" << *std::max_element(hookLatencyUs.begin(), hookLatencyUs.end()) << "\n";
+    }
+    ok = ok && patternsOk;
+    std::cout << (ok ? "OK" : "MISMATCH") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,296 @@
+// Headless replay of a recorded VRChat output_log through FishingCycle.
+//
+// Keyword lines are fed to the cycle at the time printed on them, on a
+// ScaledClock running --speed times faster than real time, with clicks going
+// to a counting sink instead of VRChat. With --sim the cycle runs on a
+// SimulatedClock instead: single-threaded, deterministic, and as fast as the
+// logic allows. Prints the counters the GUI would have shown at the end of the
+// session.
+//
+//   replay <output_log_*.txt> [--speed N | --sim] [--cast S] [--rest S]
+//          [--timeout MIN] [--no-cast] [--cast-timing timer|precise|timetag]
+//          [--verbose] [--phases FILE]
+//
+// --phases writes the per-phase p50/p95/p99 table as CSV, in the same format
+// as the GUI's export, so runs with different settings can be compared.
+
+#include "FishingClock.h"
+#include "FishingConfig.h"
+#include "FishingCycle.h"
+#include "KeywordMatcher.h"
+#include "LineSplitter.h"
+#include "LogEvent.h"
+#include "LogTimestamp.h"
+#include "OscSink.h"
+#include "RecentLogRing.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+class CountingSink : public OscSink {
+public:
+    bool sendClick(bool press) override {
+        (press ? presses_ : releases_).fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    uint64_t presses() const { return presses_.load(); }
+    uint64_t releases() const { return releases_.load(); }
+
+private:
+    std::atomic<uint64_t> presses_{ 0 };
+    std::atomic<uint64_t> releases_{ 0 };
+};
+
+struct ReplayOptions {
+    std::string logPath;
+    double speed = 100.0;
+    double castTime = FishingConfig::DEFAULT_CAST_TIME;
+    double restTime = FishingConfig::DEFAULT_REST_TIME;
+    double timeoutMinutes = FishingConfig::DEFAULT_TIMEOUT_MINUTES;
+    bool noCast = false;
+    CastTiming castTiming = CastTiming::Timer;
+    bool simulate = false;
+    bool verbose = false;
+    std::string phasesPath;
+};
+
+void printUsage(const char* argv0) {
+    std::cerr << "usage: " << argv0 << " <output_log.txt> [--speed N | --sim] [--cast S] [--rest S]"
+              << " [--timeout MIN] [--no-cast] [--cast-timing timer|precise|timetag]"
+              << " [--verbose] [--phases FILE]" << std::endl;
+}
+
+bool parseArgs(int argc, char** argv, ReplayOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--speed") == 0 && hasValue) {
+            options.speed = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--cast") == 0 && hasValue) {
+            options.castTime = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--rest") == 0 && hasValue) {
+            options.restTime = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--timeout") == 0 && hasValue) {
+            options.timeoutMinutes = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--cast-timing") == 0 && hasValue) {
+            const char* name = argv[++i];
+            size_t timing = 0;
+            while (timing < kCastTimingCount && std::strcmp(name, kCastTimingNames[timing]) != 0) {
+                ++timing;
+            }
+            if (timing == kCastTimingCount) {
+                return false;
+            }
+            options.castTiming = static_cast<CastTiming>(timing);
+        } else if (std::strcmp(arg, "--phases") == 0 && hasValue) {
+            options.phasesPath = argv[++i];
+        } else if (std::strcmp(arg, "--sim") == 0) {
+            options.simulate = true;
+        } else if (std::strcmp(arg, "--no-cast") == 0) {
+            options.noCast = true;
+        } else if (std::strcmp(arg, "--verbose") == 0) {
+            options.verbose = true;
+        } else if (arg[0] != '-' && options.logPath.empty()) {
+            options.logPath = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options.logPath.empty() && options.speed > 0.0;
+}
+
+bool readFile(const std::string& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    out = contents.str();
+    return true;
+}
+
+// Timestamp of the first line that has one, or nullopt for a log with none
+std::optional<std::chrono::system_clock::time_point> firstTimestamp(std::string_view text) {
+    std::optional<std::chrono::system_clock::time_point> first;
+    forEachLine(text, [&](std::string_view line) {
+        first = parseLogTimestamp(line);
+        return !first;
+    });
+    return first;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ReplayOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::string text;
+    if (!readFile(options.logPath, text)) {
+        std::cerr << "cannot read " << options.logPath << std::endl;
+        return 1;
+    }
+
+    auto origin = firstTimestamp(text);
+    if (!origin) {
+        std::cerr << "no timestamped lines in " << options.logPath << std::endl;
+        return 1;
+    }
+
+    KeywordMatcher matcher;
+    std::array<KeywordMatcher::Mask, kLogEventTypeCount> typeMasks{};
+    const char* keywords[kLogEventTypeCount] = { kFishHookKeyword, kFishPickupKeyword, kBucketSaveKeyword };
+    for (size_t i = 0; i < kLogEventTypeCount; ++i) {
+        typeMasks[i] = KeywordMatcher::Mask{ 1 } << matcher.addPattern(keywords[i]);
+    }
+    matcher.compile();
+
+    CountingSink sink;
+    RecentLogRing recentEvents(FishingConfig::RECENT_EVENT_CAPACITY);
+    std::optional<ScaledClock> scaledClock;
+    std::optional<SimulatedClock> simulatedClock;
+    std::optional<FishingCycle> cycleStorage;
+    if (options.simulate) {
+        cycleStorage.emplace(simulatedClock.emplace(*origin), sink);
+    } else {
+        cycleStorage.emplace(scaledClock.emplace(options.speed, *origin), sink);
+    }
+    FishingCycle& cycle = *cycleStorage;
+    FishingClock& clock = cycle.clock();
+
+    // Lets simulated time pass: a jump for --sim, a scaled sleep otherwise
+    auto advance = [&](std::chrono::steady_clock::duration duration) {
+        if (options.simulate) {
+            cycle.runUntil(clock.now() + duration);
+        } else {
+            clock.sleepFor(duration);
+        }
+    };
+
+    FishingSettings& settings = cycle.settings();
+    settings.castTime.store(options.castTime);
+    settings.restTime.store(options.restTime);
+    settings.timeoutLimit.store(options.timeoutMinutes);
+    settings.noCastMode.store(options.noCast);
+    settings.castTiming.store(options.castTiming);
+
+    cycle.setRecentEventLookup([&recentEvents](LogEventType type, std::chrono::system_clock::time_point minTime, uint64_t& cursor) {
+        return recentEvents.findSince(type, minTime, cursor);
+    });
+    if (options.verbose) {
+        cycle.setStatusCallback([&clock, &origin](FishingState state) {
+            double at = std::chrono::duration<double>(clock.wallNow() - *origin).count();
+            std::cout << std::fixed << std::setprecision(1) << std::setw(9) << at << "s  " << fishingStateName(state) << "\n";
+        });
+    }
+
+    std::array<uint64_t, kLogEventTypeCount> eventCounts{};
+    auto realStart = std::chrono::steady_clock::now();
+    {
+        cycle.start();
+
+        forEachLine(text, [&](std::string_view line) {
+            KeywordMatcher::Mask hits = matcher.scan(line);
+            if (hits == 0) {
+                return true;
+            }
+
+            LogEvent event{};
+            event.timestamp = parseLogTimestamp(line);
+            if (event.timestamp) {
+                advance(std::chrono::duration_cast<std::chrono::steady_clock::duration>(*event.timestamp - clock.wallNow()));
+            }
+            event.observedAt = clock.now();
+            event.fileOffset = static_cast<uint64_t>(line.data() - text.data());
+
+            uint32_t typeMask = 0;
+            for (LogEventType type : kLogEventTypes) {
+                if (hits & typeMasks[static_cast<size_t>(type)]) {
+                    typeMask |= 1u << static_cast<uint32_t>(type);
+                }
+            }
+            recentEvents.push(typeMask, event.timestamp);
+
+            for (LogEventType type : kLogEventTypes) {
+                if (typeMask & (1u << static_cast<uint32_t>(type))) {
+                    event.type = type;
+                    eventCounts[static_cast<size_t>(type)]++;
+                    cycle.onLogEvent(event);
+                }
+            }
+            return true;
+        });
+
+        // Let the last reel and bucket check finish before reading the counters
+        advance(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(FishingConfig::FISH_PICKUP_WAIT_TIME + FishingConfig::BUCKET_SAVE_TIMEOUT_SECONDS)));
+    }
+
+    FishingStats stats = cycle.getStats();
+    CastDispatchStats dispatch = cycle.getCastDispatchStats();
+    MailboxStats mailbox = cycle.getMailboxStats();
+    std::array<PhaseLatency, kCyclePhaseCount> phases = cycle.getPhaseLatencies();
+    PhaseLatency castHoldError = cycle.getCastHoldError();
+    double simulated = std::chrono::duration<double>(clock.wallNow() - *origin).count();
+    cycle.shutdown();
+    double real = std::chrono::duration<double>(std::chrono::steady_clock::now() - realStart).count();
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "log:            " << options.logPath << "\n"
+              << "simulated:      " << simulated << "s in " << std::setprecision(3) << real << "s ";
+    if (options.simulate) {
+        std::cout << "(discrete-event, x" << std::setprecision(0) << simulated / real << ")\n";
+    } else {
+        std::cout << "(x" << options.speed << ")\n";
+    }
+    std::cout << std::setprecision(1)
+              << "events:         hook=" << eventCounts[static_cast<size_t>(LogEventType::FishOnHook)]
+              << " pickup=" << eventCounts[static_cast<size_t>(LogEventType::FishPickup)]
+              << " bucket=" << eventCounts[static_cast<size_t>(LogEventType::BucketSave)] << "\n"
+              << "reels:          " << stats.reels << "\n"
+              << "bucket success: " << stats.bucketSuccess << "\n"
+              << "timeouts:       " << stats.timeouts << "\n"
+              << "clicks:         press=" << sink.presses() << " release=" << sink.releases() << "\n"
+              << std::setprecision(3)
+              << "cast dispatch:  n=" << dispatch.count << " mean=" << dispatch.meanMs()
+              << "ms max=" << dispatch.maxMs << "ms (scaled)\n"
+              << "mailbox:        n=" << mailbox.processed << " depth<=" << mailbox.maxDepth
+              << " mean=" << mailbox.meanMs() << "ms max=" << mailbox.maxMs << "ms (scaled)\n";
+
+    std::cout << std::setprecision(1) << "phases (ms):    " << std::setw(14) << "n"
+              << std::setw(10) << "p50" << std::setw(10) << "p95" << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+    for (size_t i = 0; i < kCyclePhaseCount; ++i) {
+        std::cout << "  " << std::left << std::setw(14) << kCyclePhaseNames[i] << std::right
+                  << std::setw(14) << phases[i].count << std::setw(10) << phases[i].p50Ms
+                  << std::setw(10) << phases[i].p95Ms << std::setw(10) << phases[i].p99Ms
+                  << std::setw(10) << phases[i].maxMs << "\n";
+    }
+    std::cout << std::setprecision(3) << "cast hold error: p50=" << castHoldError.p50Ms << "ms p99=" << castHoldError.p99Ms
+              << "ms max=" << castHoldError.maxMs << "ms (scaled)" << std::endl;
+
+    if (!options.phasesPath.empty()) {
+        std::ofstream phasesFile(options.phasesPath);
+        cycle.writePhaseReport(phasesFile);
+        if (!phasesFile) {
+            std::cerr << "cannot write " << options.phasesPath << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
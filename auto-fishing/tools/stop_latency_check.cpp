@@ -0,0 +1,338 @@
+// Stop latency check: runs the real FishingCycle, with its actor thread,
+// TimerScheduler and PreciseTimer, stops it in the middle of each long wait,
+// and measures in real time how long it takes to go idle (state Stopped,
+// button released):
+//
+//   cast hold      castTime at MAX_CAST_TIME, "timer" and "precise" timing
+//   bite wait      timeoutLimit at MAX_TIMEOUT_MINUTES
+//   pickup wait    after a bite, up to FISH_PICKUP_TIMEOUT
+//   rest           restTime at MAX_REST_TIME, after a landed fish
+//   waitFor        an outside thread's hour-long waitFor(), cancelled by stop()
+//   shutdown       shutdown() during the rest, timed until it returns
+//   scheduler      TimerScheduler::shutdown() with a timer an hour out, on a
+//                  SystemClock
+//
+// The cycle runs on a ScaledClock --speedup times faster than real time, so
+// the bite (accepted only HOOK_MIN_WAIT_SECONDS into the wait) comes quickly.
+// Every wait stopped is still long in real time at that speed. Each scenario
+// runs --rounds times; the slowest round of every scenario must be within
+// --bound-ms.
+//
+//   stop_latency_check [--rounds N] [--bound-ms MS] [--speedup X]
+
+#include "FishingClock.h"
+#include "FishingConfig.h"
+#include "FishingCycle.h"
+#include "FishingState.h"
+#include "LogEvent.h"
+#include "OscSink.h"
+#include "TimerScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int rounds = 5;
+    double boundMs = 5.0;
+    double speedup = 20.0;
+};
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--rounds") == 0 && hasValue) {
+            options.rounds = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--bound-ms") == 0 && hasValue) {
+            options.boundMs = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--speedup") == 0 && hasValue) {
+            options.speedup = std::atof(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return options.rounds > 0 && options.boundMs > 0.0 && options.speedup >= 1.0;
+}
+
+double millisSince(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+// Records when the cycle enters each state and when the button goes up
+class Probe : public OscSink {
+public:
+    bool sendClick(bool press) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pressed_ = press;
+        if (!press) {
+            releasedAt_ = Clock::now();
+        }
+        return true;
+    }
+
+    void onState(FishingState state) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            state_ = state;
+            enteredAt_[static_cast<size_t>(state)] = Clock::now();
+        }
+        changed_.notify_all();
+    }
+
+    // Waits up to a few real seconds for the state; false if it never came
+    bool waitFor(FishingState state) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return changed_.wait_for(lock, std::chrono::seconds(5), [&]() { return state_ == state; });
+    }
+
+    std::optional<Clock::time_point> enteredAt(FishingState state) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return enteredAt_[static_cast<size_t>(state)];
+    }
+
+    // When the button went up last, if it is up now
+    std::optional<Clock::time_point> releasedAt() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pressed_) {
+            return std::nullopt;
+        }
+        return releasedAt_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    FishingState state_ = FishingState::Waiting;
+    std::optional<Clock::time_point> enteredAt_[kFishingStateCount];
+    bool pressed_ = false;
+    std::optional<Clock::time_point> releasedAt_;
+};
+
+enum class Stage { CastHold, BiteWait, PickupWait, Rest };
+
+enum class StopBy { Stop, WaitFor, Shutdown };
+
+struct Scenario {
+    const char* name;
+    Stage stage;
+    CastTiming timing;
+    StopBy stopBy;
+};
+
+const Scenario kScenarios[] = {
+    { "cast hold (timer)", Stage::CastHold, CastTiming::Timer, StopBy::Stop },
+    { "cast hold (precise)", Stage::CastHold, CastTiming::Precise, StopBy::Stop },
+    { "bite wait", Stage::BiteWait, CastTiming::Timer, StopBy::Stop },
+    { "pickup wait", Stage::PickupWait, CastTiming::Timer, StopBy::Stop },
+    { "rest", Stage::Rest, CastTiming::Timer, StopBy::Stop },
+    { "waitFor", Stage::BiteWait, CastTiming::Timer, StopBy::WaitFor },
+    { "shutdown", Stage::Rest, CastTiming::Timer, StopBy::Shutdown },
+};
+
+LogEvent makeEvent(FishingCycle& cycle, LogEventType type) {
+    LogEvent event{};
+    event.type = type;
+    event.timestamp = cycle.clock().wallNow();
+    event.observedAt = cycle.clock().now();
+    return event;
+}
+
+// Sleeps for as long in real time as the given seconds take on the cycle's clock
+void sleepCycleTime(double seconds, double speedup) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds / speedup));
+}
+
+// Brings a fresh cycle to the scenario's wait, stops it there, and returns
+// the real milliseconds from the stop until it is idle; nullopt on failure
+std::optional<double> runRound(const Scenario& scenario, const Options& options, std::string& error) {
+    ScaledClock clock(options.speedup, std::chrono::system_clock::now());
+    Probe probe;
+    FishingCycle cycle(clock, probe);
+    cycle.setDiagnosticStream(nullptr);
+    cycle.setStatusCallback([&](FishingState state) { probe.onState(state); });
+    FishingSettings& settings = cycle.settings();
+    settings.castTime = FishingConfig::MAX_CAST_TIME;
+    settings.restTime = FishingConfig::MAX_REST_TIME;
+    settings.timeoutLimit = FishingConfig::MAX_TIMEOUT_MINUTES;
+    settings.castTiming = scenario.timing;
+    cycle.start();
+
+    FishingState target = FishingState::Casting;
+    if (scenario.stage != Stage::CastHold) {
+        target = FishingState::WaitingFish;
+        if (!probe.waitFor(target)) {
+            error = "never reached WaitingFish";
+            return std::nullopt;
+        }
+    }
+    if (scenario.stage == Stage::PickupWait || scenario.stage == Stage::Rest) {
+        // The hook is accepted only HOOK_MIN_WAIT_SECONDS into the wait
+        sleepCycleTime(FishingConfig::HOOK_MIN_WAIT_SECONDS + 0.5, options.speedup);
+        cycle.onLogEvent(makeEvent(cycle, LogEventType::FishOnHook));
+        target = FishingState::Reeling;
+    }
+    if (scenario.stage == Stage::Rest) {
+        if (!probe.waitFor(target)) {
+            error = "the bite was not taken";
+            return std::nullopt;
+        }
+        cycle.onLogEvent(makeEvent(cycle, LogEventType::FishPickup));
+        target = FishingState::Resting;
+    }
+    if (!probe.waitFor(target)) {
+        error = "never reached the wait to stop";
+        return std::nullopt;
+    }
+
+    // Resolves with when the outside wait returned, if it was cancelled
+    std::promise<std::optional<Clock::time_point>> waitReturned;
+    std::future<std::optional<Clock::time_point>> waitReturnedAt = waitReturned.get_future();
+    std::thread waiter;
+    if (scenario.stopBy == StopBy::WaitFor) {
+        waiter = std::thread([&]() {
+            FishingCycle::WaitResult result = cycle.waitFor(std::chrono::hours(1));
+            auto returnedAt = Clock::now();
+            waitReturned.set_value(result == FishingCycle::WaitResult::Cancelled
+                ? std::optional<Clock::time_point>(returnedAt) : std::nullopt);
+        });
+    }
+
+    // Let the coroutine and any waiter settle into their waits
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    if (cycle.getState() != target) {
+        error = "the wait ended on its own before the stop";
+        cycle.shutdown();
+        if (waiter.joinable()) {
+            waiter.join();
+        }
+        return std::nullopt;
+    }
+
+    auto stopAt = Clock::now();
+    std::optional<Clock::time_point> idleAt;
+    if (scenario.stopBy == StopBy::Shutdown) {
+        cycle.shutdown();
+        idleAt = Clock::now();
+    } else if (scenario.stopBy == StopBy::WaitFor) {
+        cycle.stop();
+        if (waitReturnedAt.wait_for(std::chrono::seconds(5)) == std::future_status::ready) {
+            idleAt = waitReturnedAt.get();
+        }
+        // shutdown() cancels the wait if stop() did not
+        cycle.shutdown();
+        waiter.join();
+    } else {
+        cycle.stop();
+        if (probe.waitFor(FishingState::Stopped)) {
+            idleAt = probe.enteredAt(FishingState::Stopped);
+        }
+    }
+    std::optional<Clock::time_point> releasedAt = probe.releasedAt();
+    cycle.shutdown();
+
+    if (!idleAt) {
+        error = scenario.stopBy == StopBy::WaitFor ? "waitFor was not cancelled by stop()" : "never went idle";
+        return std::nullopt;
+    }
+    if (!releasedAt) {
+        error = "the button was left pressed";
+        return std::nullopt;
+    }
+    return millisSince(stopAt, std::max(*idleAt, *releasedAt));
+}
+
+// TimerScheduler::shutdown() with a timer an hour out and an idle scheduler
+double schedulerRound() {
+    SystemClock clock;
+    TimerScheduler timers(clock);
+    std::atomic<bool> fired{ false };
+    timers.schedule(std::chrono::hours(1), [&]() { fired = true; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto stopAt = Clock::now();
+    timers.shutdown();
+    double ms = millisSince(stopAt, Clock::now());
+    return fired ? -1.0 : ms;
+}
+
+struct Row {
+    std::string name;
+    double maxMs = 0.0;
+    double totalMs = 0.0;
+    int rounds = 0;
+    std::string error;
+};
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--rounds N] [--bound-ms MS] [--speedup X]" << std::endl;
+        return 2;
+    }
+
+    std::vector<Row> rows;
+    for (const Scenario& scenario : kScenarios) {
+        Row row;
+        row.name = scenario.name;
+        for (int round = 0; round < options.rounds && row.error.empty(); ++round) {
+            std::optional<double> ms = runRound(scenario, options, row.error);
+            if (ms) {
+                row.maxMs = std::max(row.maxMs, *ms);
+                row.totalMs += *ms;
+                row.rounds++;
+            }
+        }
+        rows.push_back(row);
+    }
+    Row scheduler;
+    scheduler.name = "scheduler";
+    for (int round = 0; round < options.rounds && scheduler.error.empty(); ++round) {
+        double ms = schedulerRound();
+        if (ms < 0.0) {
+            scheduler.error = "a cancelled timer fired";
+        } else {
+            scheduler.maxMs = std::max(scheduler.maxMs, ms);
+            scheduler.totalMs += ms;
+            scheduler.rounds++;
+        }
+    }
+    rows.push_back(scheduler);
+
+    bool ok = true;
+    std::cout << "stop to idle, real ms, " << options.rounds << " rounds, bound " << options.boundMs
+              << " ms, cycle clock x" << options.speedup << "\n";
+    for (const Row& row : rows) {
+        bool rowOk = row.error.empty() && row.maxMs <= options.boundMs;
+        ok = ok && rowOk;
+        std::cout << "  " << std::left << std::setw(22) << row.name << std::right << std::fixed
+                  << std::setprecision(3);
+        if (row.rounds > 0) {
+            std::cout << "mean " << std::setw(8) << row.totalMs / row.rounds << "  max " << std::setw(8) << row.maxMs;
+        }
+        if (!row.error.empty()) {
+            std::cout << "  " << row.error;
+        } else if (!rowOk) {
+            std::cout << "  over the bound";
+        }
+        std::cout << "\n";
+    }
+    std::cout << (ok ? "OK" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,671 @@
+// Monte Carlo pond simulator and parameter sweep for FishingCycle.
+//
+// Bite, pickup and bucket delays are fitted from recorded VRChat output_logs
+// (the settings those sessions ran with are given by --log-cast/--log-rest/
+// --log-timeout). A simulated pond then answers the cycle's clicks with log
+// events drawn from those delays, on a SimulatedClock, so the real cycle logic
+// decides when to cast, reel and give up. Every combination of cast time, rest
+// time and timeout on a grid spanning the FishingConfig ranges is run --runs
+// times for --hours of simulated play, spread over all cores.
+//
+// Writes one CSV row per grid point (a fish-per-hour surface) to stdout or
+// --out, and a summary of the fit and the best settings to stderr.
+//
+//   sweep [output_log_*.txt ...] [--steps N] [--hours H] [--runs N]
+//         [--threads N] [--seed N] [--random-cast | --cast-optimizer]
+//         [--adaptive-timeout PCT]
+//         [--hook-hold S] [--log-cast S] [--log-rest S] [--log-timeout MIN]
+//         [--out FILE]
+
+#include "FishingClock.h"
+#include "FishingConfig.h"
+#include "FishingCycle.h"
+#include "KeywordMatcher.h"
+#include "LineSplitter.h"
+#include "LogEvent.h"
+#include "LogTimestamp.h"
+#include "OscSink.h"
+#include "RecentLogRing.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Seconds = std::chrono::duration<double>;
+
+std::chrono::steady_clock::duration toSteady(double seconds) {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(Seconds(seconds));
+}
+
+// One delay of the pond. Observed delays are resampled with the log's
+// one-second quantisation smoothed out; delays that ran past the recorded
+// timeout are right-censored and drawn from an exponential tail instead.
+struct DelayDistribution {
+    std::vector<double> samples;
+    double censoredFraction = 0.0;
+    double tailStart = 0.0;
+    double tailRate = 0.0;
+
+    double sample(std::mt19937_64& random) const {
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        if (samples.empty() || (censoredFraction > 0.0 && unit(random) < censoredFraction)) {
+            return tailStart + std::exponential_distribution<double>(tailRate)(random);
+        }
+        double observed = samples[std::uniform_int_distribution<size_t>(0, samples.size() - 1)(random)];
+        return (std::max)(0.0, observed + unit(random) - 0.5);
+    }
+
+    double quantile(double q) const {
+        if (samples.empty()) {
+            return tailStart - std::log(1.0 - q) / tailRate;
+        }
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[static_cast<size_t>(q * (sorted.size() - 1))];
+    }
+};
+
+struct PondModel {
+    DelayDistribution bite;      // line cast -> fish on the hook
+    DelayDistribution pickup;    // hook line -> pickup line
+    DelayDistribution bucket;    // pickup line -> bucket attempt line
+    DelayDistribution save;      // bucket attempt line -> its SAVED DATA line
+    // How long a hooked fish waits to be reeled before it gets away; the logs
+    // do not show this, so it is a parameter
+    double hookHoldSeconds = 5.0;
+};
+
+// What the recorded sessions ran with; needed to turn gaps between catches into bite delays
+struct RecordedSettings {
+    double castTime = FishingConfig::DEFAULT_CAST_TIME;
+    double restTime = FishingConfig::DEFAULT_REST_TIME;
+    double timeoutMinutes = FishingConfig::DEFAULT_TIMEOUT_MINUTES;
+};
+
+struct SweepOptions {
+    std::vector<std::string> logPaths;
+    RecordedSettings recorded;
+    int steps = 6;
+    double hours = 4.0;
+    int runs = 8;
+    unsigned threads = 0;
+    uint64_t seed = 1;
+    bool randomCast = false;
+    bool castOptimizer = false;
+    // Percentile for the adaptive timeout; 0 keeps the fixed timeout
+    double adaptivePercentile = 0.0;
+    double hookHoldSeconds = PondModel{}.hookHoldSeconds;
+    std::string outPath;
+};
+
+void printUsage(const char* argv0) {
+    std::cerr << "usage: " << argv0 << " [output_log.txt ...] [--steps N] [--hours H] [--runs N]"
+              << " [--threads N] [--seed N] [--random-cast | --cast-optimizer] [--adaptive-timeout PCT] [--hook-hold S]"
+              << " [--log-cast S] [--log-rest S] [--log-timeout MIN] [--out FILE]" << std::endl;
+}
+
+bool parseArgs(int argc, char** argv, SweepOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--steps") == 0 && hasValue) {
+            options.steps = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--hours") == 0 && hasValue) {
+            options.hours = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--runs") == 0 && hasValue) {
+            options.runs = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--threads") == 0 && hasValue) {
+            options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--seed") == 0 && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--random-cast") == 0) {
+            options.randomCast = true;
+        } else if (std::strcmp(arg, "--cast-optimizer") == 0) {
+            options.castOptimizer = true;
+        } else if (std::strcmp(arg, "--adaptive-timeout") == 0 && hasValue) {
+            options.adaptivePercentile = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--hook-hold") == 0 && hasValue) {
+            options.hookHoldSeconds = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--log-cast") == 0 && hasValue) {
+            options.recorded.castTime = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--log-rest") == 0 && hasValue) {
+            options.recorded.restTime = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--log-timeout") == 0 && hasValue) {
+            options.recorded.timeoutMinutes = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--out") == 0 && hasValue) {
+            options.outPath = argv[++i];
+        } else if (arg[0] != '-') {
+            options.logPaths.push_back(arg);
+        } else {
+            return false;
+        }
+    }
+    return options.steps >= 2 && options.hours > 0.0 && options.runs >= 1;
+}
+
+bool readFile(const std::string& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    out = contents.str();
+    return true;
+}
+
+// Delays observed in one log, in seconds. A catch shows up as
+//   SAVED DATA (hook), Fish Pickup, Attempt saving, SAVED DATA (bucket)
+// and the bite delay is what is left of the gap from one catch's pickup to
+// the next hook after the cycle's fixed steps. Gaps longer than the recorded
+// timeout hide one or more timeouts: each counts as a censored bite.
+struct FitSamples {
+    std::vector<double> bite;
+    std::vector<double> pickup;
+    std::vector<double> bucket;
+    std::vector<double> save;
+    size_t censoredBites = 0;
+};
+
+void collectDelays(std::string_view text, const RecordedSettings& recorded, FitSamples& fit) {
+    KeywordMatcher matcher;
+    std::array<KeywordMatcher::Mask, kLogEventTypeCount> typeMasks{};
+    const char* keywords[kLogEventTypeCount] = { kFishHookKeyword, kFishPickupKeyword, kBucketSaveKeyword };
+    for (size_t i = 0; i < kLogEventTypeCount; ++i) {
+        typeMasks[i] = KeywordMatcher::Mask{ 1 } << matcher.addPattern(keywords[i]);
+    }
+    matcher.compile();
+
+    const double timeout = recorded.timeoutMinutes * 60.0;
+    const double afterPickup = FishingConfig::FISH_PICKUP_WAIT_TIME + recorded.restTime + recorded.castTime;
+    const double afterTimeout = (std::min)(FishingConfig::TIMEOUT_REEL_WAIT, FishingConfig::MAX_REEL_TIME)
+        + FishingConfig::FORCE_REEL_REST + recorded.castTime;
+
+    // Far enough back that every window test against it fails
+    const std::chrono::system_clock::time_point never{};
+    std::chrono::system_clock::time_point lastHook = never;
+    std::chrono::system_clock::time_point lastPickup = never;
+    std::chrono::system_clock::time_point lastAttempt = never;
+    forEachLine(text, [&](std::string_view line) {
+        KeywordMatcher::Mask hits = matcher.scan(line);
+        if (hits == 0) {
+            return true;
+        }
+        auto at = parseLogTimestamp(line);
+        if (!at) {
+            return true;
+        }
+        auto since = [&](std::chrono::system_clock::time_point earlier) { return Seconds(*at - earlier).count(); };
+
+        if (hits & typeMasks[static_cast<size_t>(LogEventType::FishOnHook)]) {
+            double sinceAttempt = since(lastAttempt);
+            if (sinceAttempt <= FishingConfig::BUCKET_SAVE_TIMEOUT_SECONDS) {
+                fit.save.push_back(sinceAttempt);
+                lastAttempt = never;
+            } else if (since(lastHook) > FishingConfig::SAVED_DATA_CLUSTER_SECONDS) {
+                // Only a landed catch tells when the cycle cast again
+                double gap = since(lastPickup) - afterPickup;
+                if (since(lastPickup) < since(lastHook) && gap >= 0.0) {
+                    while (gap >= timeout) {
+                        fit.censoredBites++;
+                        gap -= timeout + afterTimeout;
+                    }
+                    if (gap >= 0.0) {
+                        fit.bite.push_back(gap);
+                    }
+                }
+                lastHook = *at;
+            }
+        }
+        if (hits & typeMasks[static_cast<size_t>(LogEventType::FishPickup)]) {
+            double sinceHook = since(lastHook);
+            if (sinceHook <= FishingConfig::FISH_PICKUP_TIMEOUT && since(lastPickup) > sinceHook) {
+                fit.pickup.push_back(sinceHook);
+                lastPickup = *at;
+            }
+        }
+        if (hits & typeMasks[static_cast<size_t>(LogEventType::BucketSave)]) {
+            double sincePickup = since(lastPickup);
+            if (sincePickup <= FishingConfig::BUCKET_WAIT_TIMEOUT && since(lastAttempt) > sincePickup) {
+                fit.bucket.push_back(sincePickup);
+                lastAttempt = *at;
+            }
+        }
+        return true;
+    });
+}
+
+// Without observations the delay is exponential around fallbackMean
+DelayDistribution fitDelay(std::vector<double> samples, double fallbackMean) {
+    DelayDistribution delay;
+    delay.samples = std::move(samples);
+    if (delay.samples.empty()) {
+        delay.tailRate = 1.0 / fallbackMean;
+    }
+    return delay;
+}
+
+// Censored bites continue past the recorded timeout at the hazard seen over
+// the second half of the observed range (bites there per second of waiting)
+DelayDistribution fitBiteDelay(const FitSamples& fit, double timeout, double fallbackMean) {
+    DelayDistribution bite = fitDelay(fit.bite, fallbackMean);
+    if (fit.censoredBites == 0 || fit.bite.empty()) {
+        return bite;
+    }
+    double from = timeout / 2.0;
+    double events = 0.0;
+    double exposure = fit.censoredBites * (timeout - from);
+    for (double delay : fit.bite) {
+        if (delay >= from) {
+            events += 1.0;
+            exposure += delay - from;
+        }
+    }
+    bite.censoredFraction = static_cast<double>(fit.censoredBites) / (fit.censoredBites + fit.bite.size());
+    bite.tailStart = timeout;
+    bite.tailRate = events > 0.0 ? events / exposure : 1.0 / fallbackMean;
+    return bite;
+}
+
+// The game side of the cycle: reacts to clicks the way the rod does and
+// writes the log lines the cycle waits for, stamped to the second like
+// VRChat's. Single-threaded; lives on the same SimulatedClock as the cycle.
+class SimulatedPond : public OscSink {
+public:
+    SimulatedPond(SimulatedClock& clock, const PondModel& model, uint64_t seed)
+        : clock_(clock), model_(model), random_(seed) {}
+
+    void attach(FishingCycle& cycle, RecentLogRing& recentEvents) {
+        cycle_ = &cycle;
+        recentEvents_ = &recentEvents;
+    }
+
+    bool sendClick(bool press) override {
+        auto now = clock_.now();
+        if (press) {
+            switch (rod_) {
+                case Rod::Idle:
+                    rod_ = Rod::Casting;
+                    castPressedAt_ = now;
+                    break;
+                case Rod::InWater:
+                    rod_ = Rod::Reeling;
+                    ++rodGeneration_;
+                    break;
+                case Rod::Hooked:
+                    rod_ = Rod::ReelingFish;
+                    schedule((std::max)(now, hookedAt_ + toSteady(model_.pickup.sample(random_))), Happening::Pickup, true);
+                    break;
+                default:
+                    break;
+            }
+        } else {
+            switch (rod_) {
+                case Rod::Casting:
+                    // No cast is held longer than MAX_CAST_TIME; a longer hold on
+                    // an idle rod is the bucket-recovery timeout reel, which
+                    // winds in an empty line and leaves the rod idle for the
+                    // cycle's next cast instead of casting one of its own
+                    if (now - castPressedAt_ > toSteady(FishingConfig::MAX_CAST_TIME)) {
+                        rod_ = Rod::Idle;
+                        emptyReels_++;
+                        break;
+                    }
+                    rod_ = Rod::InWater;
+                    schedule(now + toSteady(model_.bite.sample(random_)), Happening::Bite, true);
+                    break;
+                case Rod::Landed: {
+                    landed_++;
+                    auto attemptAt = (std::max)(now, pickedUpAt_ + toSteady(model_.bucket.sample(random_)));
+                    schedule(attemptAt, Happening::BucketAttempt, false);
+                    schedule(attemptAt + toSteady(model_.save.sample(random_)), Happening::BucketSaved, false);
+                    rod_ = Rod::Idle;
+                    break;
+                }
+                case Rod::Reeling:
+                case Rod::ReelingFish:
+                    rod_ = Rod::Idle;
+                    ++rodGeneration_;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return true;
+    }
+
+    std::optional<std::chrono::steady_clock::time_point> nextHappeningAt() const {
+        if (happenings_.empty()) {
+            return std::nullopt;
+        }
+        return happenings_.top().at;
+    }
+
+    // Writes the log lines for everything due by now
+    void fireDue() {
+        auto now = clock_.now();
+        while (!happenings_.empty() && happenings_.top().at <= now) {
+            Scheduled next = happenings_.top();
+            happenings_.pop();
+            if (next.rodBound && next.rodGeneration != rodGeneration_) {
+                continue;
+            }
+            switch (next.what) {
+                case Happening::Bite:
+                    if (rod_ == Rod::InWater) {
+                        rod_ = Rod::Hooked;
+                        hookedAt_ = now;
+                        schedule(now + toSteady(model_.hookHoldSeconds), Happening::Escape, true);
+                        emit(LogEventType::FishOnHook);
+                    }
+                    break;
+                case Happening::Escape:
+                    // Nothing else bites on this cast
+                    if (rod_ == Rod::Hooked) {
+                        rod_ = Rod::InWater;
+                    }
+                    break;
+                case Happening::Pickup:
+                    if (rod_ == Rod::ReelingFish) {
+                        rod_ = Rod::Landed;
+                        pickedUpAt_ = now;
+                        emit(LogEventType::FishPickup);
+                    }
+                    break;
+                case Happening::BucketAttempt:
+                    emit(LogEventType::BucketSave);
+                    break;
+                case Happening::BucketSaved:
+                    emit(LogEventType::FishOnHook);
+                    break;
+            }
+        }
+    }
+
+    uint64_t landed() const { return landed_; }
+    // Reels with no line out, as after a bucket recovery
+    uint64_t emptyReels() const { return emptyReels_; }
+
+private:
+    enum class Rod { Idle, Casting, InWater, Hooked, Reeling, ReelingFish, Landed };
+    enum class Happening { Bite, Escape, Pickup, BucketAttempt, BucketSaved };
+
+    struct Scheduled {
+        std::chrono::steady_clock::time_point at;
+        uint64_t sequence;
+        Happening what;
+        bool rodBound;
+        uint64_t rodGeneration;
+
+        bool operator>(const Scheduled& other) const {
+            return at != other.at ? at > other.at : sequence > other.sequence;
+        }
+    };
+
+    // rodBound happenings are dropped once the line comes out of the water
+    void schedule(std::chrono::steady_clock::time_point at, Happening what, bool rodBound) {
+        happenings_.push(Scheduled{ at, nextSequence_++, what, rodBound, rodGeneration_ });
+    }
+
+    void emit(LogEventType type) {
+        LogEvent event{};
+        event.type = type;
+        event.timestamp = std::chrono::floor<std::chrono::seconds>(clock_.wallNow());
+        event.observedAt = clock_.now();
+        event.fileOffset = nextSequence_++;
+        recentEvents_->push(1u << static_cast<uint32_t>(type), event.timestamp);
+        cycle_->onLogEvent(event);
+    }
+
+    SimulatedClock& clock_;
+    const PondModel& model_;
+    std::mt19937_64 random_;
+    FishingCycle* cycle_ = nullptr;
+    RecentLogRing* recentEvents_ = nullptr;
+
+    Rod rod_ = Rod::Idle;
+    uint64_t rodGeneration_ = 0;
+    std::chrono::steady_clock::time_point hookedAt_;
+    std::chrono::steady_clock::time_point pickedUpAt_;
+    std::chrono::steady_clock::time_point castPressedAt_;
+    std::priority_queue<Scheduled, std::vector<Scheduled>, std::greater<Scheduled>> happenings_;
+    uint64_t nextSequence_ = 0;
+    uint64_t landed_ = 0;
+    uint64_t emptyReels_ = 0;
+};
+
+struct GridPoint {
+    double castTime;
+    double restTime;
+    double timeoutMinutes;
+};
+
+struct RunResult {
+    double fish = 0.0;
+    double timeouts = 0.0;
+    double bucketConfirmed = 0.0;
+    double emptyReels = 0.0;
+};
+
+// Plays hours of simulated time, stepping cycle and pond from one deadline to the next
+RunResult simulate(const PondModel& model, const GridPoint& point, const SweepOptions& options, uint64_t seed) {
+    SimulatedClock clock(std::chrono::sys_days{ std::chrono::year{ 2025 } / 1 / 1 });
+    SimulatedPond pond(clock, model, seed);
+    RecentLogRing recentEvents(FishingConfig::RECENT_EVENT_CAPACITY);
+    FishingCycle cycle(clock, pond);
+    pond.attach(cycle, recentEvents);
+
+    FishingSettings& settings = cycle.settings();
+    settings.castTime.store(point.castTime);
+    settings.randomCastEnabled.store(options.randomCast);
+    settings.castOptimizerEnabled.store(options.castOptimizer);
+    settings.randomCastMax.store(point.castTime);
+    settings.restTime.store(point.restTime);
+    settings.timeoutLimit.store(point.timeoutMinutes);
+    settings.adaptiveTimeout.store(options.adaptivePercentile > 0.0);
+    if (options.adaptivePercentile > 0.0) {
+        settings.adaptiveTimeoutPercentile.store(options.adaptivePercentile);
+    }
+    cycle.seedRandomCast(seed);
+    cycle.setDiagnosticStream(nullptr);
+    cycle.setRecentEventLookup([&recentEvents](LogEventType type, std::chrono::system_clock::time_point minTime, uint64_t& cursor) {
+        return recentEvents.findSince(type, minTime, cursor);
+    });
+
+    // Messages are handled before each step is chosen: a reaction can arm a
+    // timer or make the pond schedule something earlier than what was known
+    cycle.start();
+    cycle.runUntil(clock.now());
+    const auto end = clock.now() + toSteady(options.hours * 3600.0);
+    while (clock.now() < end) {
+        auto next = end;
+        if (auto at = cycle.nextTimerDeadline()) {
+            next = (std::min)(next, *at);
+        }
+        if (auto at = pond.nextHappeningAt()) {
+            next = (std::min)(next, *at);
+        }
+        cycle.runUntil(next);
+        pond.fireDue();
+        cycle.runUntil(clock.now());
+    }
+
+    FishingStats stats = cycle.getStats();
+    cycle.shutdown();
+    return RunResult{ static_cast<double>(pond.landed()), static_cast<double>(stats.timeouts),
+                      static_cast<double>(stats.bucketSuccess), static_cast<double>(pond.emptyReels()) };
+}
+
+std::vector<double> axis(double from, double to, int steps) {
+    std::vector<double> values;
+    for (int i = 0; i < steps; ++i) {
+        values.push_back(from + (to - from) * i / (steps - 1));
+    }
+    return values;
+}
+
+void printDelay(const char* name, const DelayDistribution& delay) {
+    std::cerr << "  " << std::left << std::setw(8) << name << std::right << " n=" << std::setw(5) << delay.samples.size()
+              << std::fixed << std::setprecision(1)
+              << "  p50=" << delay.quantile(0.5) << "s  p95=" << delay.quantile(0.95) << "s";
+    if (delay.samples.empty()) {
+        std::cerr << "  (built-in)";
+    } else if (delay.censoredFraction > 0.0) {
+        std::cerr << "  censored=" << std::setprecision(0) << delay.censoredFraction * 100.0
+                  << "% (tail mean " << std::setprecision(1) << 1.0 / delay.tailRate << "s past " << delay.tailStart << "s)";
+    }
+    std::cerr << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SweepOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    FitSamples fit;
+    for (const std::string& path : options.logPaths) {
+        std::string text;
+        if (!readFile(path, text)) {
+            std::cerr << "cannot read " << path << std::endl;
+            return 1;
+        }
+        collectDelays(text, options.recorded, fit);
+    }
+    if (fit.bite.empty()) {
+        std::cerr << "no catches found in the given logs; using built-in delays" << std::endl;
+    }
+
+    // Fallbacks are typical of a public VRChat fishing world
+    PondModel model;
+    model.bite = fitBiteDelay(fit, options.recorded.timeoutMinutes * 60.0, 20.0);
+    model.pickup = fitDelay(std::move(fit.pickup), 1.0);
+    model.bucket = fitDelay(std::move(fit.bucket), 3.0);
+    model.save = fitDelay(std::move(fit.save), 1.0);
+    model.hookHoldSeconds = options.hookHoldSeconds;
+    std::cerr << "fitted delays:\n";
+    printDelay("bite", model.bite);
+    printDelay("pickup", model.pickup);
+    printDelay("bucket", model.bucket);
+    printDelay("save", model.save);
+
+    std::vector<GridPoint> grid;
+    // The optimizer picks its own cast time, so that axis collapses to one point
+    std::vector<double> castAxis = options.castOptimizer
+        ? std::vector<double>{ FishingConfig::DEFAULT_CAST_TIME }
+        : axis(FishingConfig::MIN_CAST_TIME, FishingConfig::MAX_CAST_TIME, options.steps);
+    for (double cast : castAxis) {
+        for (double rest : axis(FishingConfig::MIN_REST_TIME, FishingConfig::MAX_REST_TIME, options.steps)) {
+            for (double timeout : axis(FishingConfig::MIN_TIMEOUT_MINUTES, FishingConfig::MAX_TIMEOUT_MINUTES, options.steps)) {
+                grid.push_back(GridPoint{ cast, rest, timeout });
+            }
+        }
+    }
+
+    // Run r of every grid point shares a seed, so points are compared on the same luck
+    const size_t jobCount = grid.size() * options.runs;
+    std::vector<RunResult> results(jobCount);
+    std::atomic<size_t> nextJob{ 0 };
+    unsigned threadCount = options.threads ? options.threads : (std::max)(1u, std::thread::hardware_concurrency());
+    auto realStart = std::chrono::steady_clock::now();
+    {
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < threadCount; ++i) {
+            workers.emplace_back([&] {
+                for (size_t job = nextJob++; job < jobCount; job = nextJob++) {
+                    const GridPoint& point = grid[job / options.runs];
+                    uint64_t seed = options.seed * 1000003 + job % options.runs;
+                    results[job] = simulate(model, point, options, seed);
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+    double real = Seconds(std::chrono::steady_clock::now() - realStart).count();
+
+    std::ofstream outFile;
+    if (!options.outPath.empty()) {
+        outFile.open(options.outPath);
+        if (!outFile.is_open()) {
+            std::cerr << "cannot write " << options.outPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.outPath.empty() ? std::cout : outFile;
+    out << (options.randomCast ? "random_cast_max_s" : "cast_s")
+        << ",rest_s,timeout_min,fish_per_hour,fish_per_hour_sd,timeouts_per_hour,bucket_confirmed_per_hour"
+        << ",empty_reels_per_hour\n";
+
+    std::vector<double> fishPerHour(grid.size());
+    for (size_t p = 0; p < grid.size(); ++p) {
+        double sum = 0.0;
+        double squares = 0.0;
+        RunResult total;
+        for (int r = 0; r < options.runs; ++r) {
+            const RunResult& run = results[p * options.runs + r];
+            double rate = run.fish / options.hours;
+            sum += rate;
+            squares += rate * rate;
+            total.timeouts += run.timeouts;
+            total.bucketConfirmed += run.bucketConfirmed;
+            total.emptyReels += run.emptyReels;
+        }
+        double mean = sum / options.runs;
+        double variance = options.runs > 1 ? (squares - options.runs * mean * mean) / (options.runs - 1) : 0.0;
+        double runHours = options.hours * options.runs;
+        fishPerHour[p] = mean;
+        out << std::fixed << std::setprecision(2);
+        if (options.castOptimizer) {
+            out << "auto,";
+        } else {
+            out << grid[p].castTime << ",";
+        }
+        out << grid[p].restTime << ","
+            << grid[p].timeoutMinutes << "," << mean << "," << std::sqrt((std::max)(0.0, variance)) << ","
+            << total.timeouts / runHours << "," << total.bucketConfirmed / runHours << ","
+            << total.emptyReels / runHours << "\n";
+    }
+    out.flush();
+
+    std::vector<size_t> ranked(grid.size());
+    for (size_t p = 0; p < ranked.size(); ++p) {
+        ranked[p] = p;
+    }
+    std::sort(ranked.begin(), ranked.end(), [&](size_t a, size_t b) { return fishPerHour[a] > fishPerHour[b]; });
+    std::cerr << std::fixed << std::setprecision(1)
+              << "simulated " << jobCount << " runs x " << options.hours << "h on " << threadCount
+              << " threads in " << std::setprecision(2) << real << "s\n"
+              << "best settings (fish/h):\n";
+    for (size_t i = 0; i < (std::min)(ranked.size(), size_t{ 5 }); ++i) {
+        const GridPoint& point = grid[ranked[i]];
+        if (options.castOptimizer) {
+            std::cerr << "  cast auto";
+        } else {
+            std::cerr << "  " << (options.randomCast ? "random cast <= " : "cast ") << point.castTime << "s";
+        }
+        std::cerr << "  rest " << point.restTime << "s  timeout " << point.timeoutMinutes
+                  << "min  => " << fishPerHour[ranked[i]] << "\n";
+    }
+    std::cerr.flush();
+    return 0;
+}
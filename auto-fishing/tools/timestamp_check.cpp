@@ -0,0 +1,340 @@
+// Equivalence check and benchmark of parseLogTimestamp against the
+// std::regex + std::stoi + std::mktime parser it replaced
+// (AutoFishingApp::extractLogTimestamp).
+//
+// For each time zone, finds every DST transition between 2018 and 2026 and
+// parses the local times of the day before, the day of and the day after it,
+// every 17 seconds (so all seconds of the minute come up), in log order. That
+// covers the skipped hour in spring, the repeated hour in autumn, half-hour
+// shifts (Lord Howe), negative DST (Dublin) and transitions at midnight
+// (Sao Paulo 2018). The same lines then go through again shuffled, so the
+// per-hour cache also misses across transitions, and a few malformed and
+// embedded timestamps are checked in every zone.
+//
+// Each line is held to the instant the local clock showed it at, found with
+// mktime and a fixed tm_isdst: for a repeated time the first of the two, for
+// a skipped time the one read with the offset before the change. The old
+// parser passed tm_isdst = -1, which glibc resolves by the offset of its
+// previous call, so on those times its answer depended on what was parsed
+// before; where it strays from the expected instant it is counted, not failed.
+//
+// Then times both parsers over a log-ordered run of lines in the first zone.
+// Sets TZ, so POSIX only; builds on Linux like the other tools.
+//
+//   timestamp_check [--zone NAME]... [--bench-lines N]
+
+#include "LogTimestamp.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace {
+
+using TimePoint = std::chrono::system_clock::time_point;
+
+const char* const kDefaultZones[] = {
+    "America/New_York", "Europe/Berlin", "Europe/Dublin", "Australia/Sydney",
+    "Australia/Lord_Howe", "America/Sao_Paulo", "Asia/Tokyo", "UTC",
+};
+
+// AutoFishingApp::extractLogTimestamp before parseLogTimestamp
+std::optional<TimePoint> extractLogTimestamp(const std::string& line) {
+    static const std::regex kLineTimePattern(R"((\d{4})\.(\d{2})\.(\d{2}) (\d{2}):(\d{2}):(\d{2}))");
+    std::smatch match;
+    if (!std::regex_search(line, match, kLineTimePattern) || match.size() < 7) {
+        return std::nullopt;
+    }
+
+    std::tm tmValue{};
+    tmValue.tm_year = std::stoi(match[1].str()) - 1900;
+    tmValue.tm_mon = std::stoi(match[2].str()) - 1;
+    tmValue.tm_mday = std::stoi(match[3].str());
+    tmValue.tm_hour = std::stoi(match[4].str());
+    tmValue.tm_min = std::stoi(match[5].str());
+    tmValue.tm_sec = std::stoi(match[6].str());
+    tmValue.tm_isdst = -1;
+
+    std::time_t localTime = std::mktime(&tmValue);
+    if (localTime == static_cast<std::time_t>(-1)) {
+        return std::nullopt;
+    }
+    return std::chrono::system_clock::from_time_t(localTime);
+}
+
+struct Options {
+    std::vector<std::string> zones;
+    long benchLines = 200000;
+};
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--zone") == 0 && hasValue) {
+            options.zones.push_back(argv[++i]);
+        } else if (std::strcmp(arg, "--bench-lines") == 0 && hasValue) {
+            options.benchLines = std::atol(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    if (options.zones.empty()) {
+        options.zones.assign(std::begin(kDefaultZones), std::end(kDefaultZones));
+    }
+    return options.benchLines > 0;
+}
+
+void setZone(const std::string& zone) {
+    setenv("TZ", zone.c_str(), 1);
+    tzset();
+}
+
+// Local calendar days on which the UTC offset changes
+std::vector<std::chrono::sys_days> transitionDays() {
+    std::vector<std::chrono::sys_days> days;
+    std::time_t t = std::chrono::system_clock::to_time_t(
+        std::chrono::sys_days{ std::chrono::year{ 2018 } / 1 / 1 });
+    std::time_t end = std::chrono::system_clock::to_time_t(
+        std::chrono::sys_days{ std::chrono::year{ 2027 } / 1 / 1 });
+    std::tm local{};
+    localtime_r(&t, &local);
+    long offset = local.tm_gmtoff;
+    for (; t < end; t += 900) {
+        localtime_r(&t, &local);
+        if (local.tm_gmtoff != offset) {
+            offset = local.tm_gmtoff;
+            days.push_back(std::chrono::sys_days{ std::chrono::year{ local.tm_year + 1900 }
+                                                  / (local.tm_mon + 1) / local.tm_mday });
+        }
+    }
+    return days;
+}
+
+// "YYYY.MM.DD HH:MM:SS" wall-clock text, as VRChat prints it
+std::string logLine(std::chrono::sys_days day, long secondOfDay, const char* rest) {
+    std::chrono::year_month_day date{ day };
+    char text[96];
+    std::snprintf(text, sizeof(text), "%04d.%02u.%02u %02ld:%02ld:%02ld %s",
+                  static_cast<int>(date.year()), static_cast<unsigned>(date.month()),
+                  static_cast<unsigned>(date.day()), secondOfDay / 3600, (secondOfDay / 60) % 60,
+                  secondOfDay % 60, rest);
+    return text;
+}
+
+std::vector<std::string> transitionLines(const std::vector<std::chrono::sys_days>& days) {
+    std::vector<std::string> lines;
+    for (std::chrono::sys_days day : days) {
+        for (long second = 0; second < 3 * 86400; second += 17) {
+            lines.push_back(logLine(day - std::chrono::days{ 1 } + std::chrono::days{ second / 86400 },
+                                    second % 86400, "Log        -  [FishingSystem] SAVED DATA"));
+        }
+    }
+    return lines;
+}
+
+const char* const kEdgeLines[] = {
+    "",
+    "2026.03.29",
+    "2026.03.29 02:30:0",
+    "2026.03.29 02:30:00",
+    "prefix 2026.10.25 02:30:00 Log - timestamp not at the start",
+    "2026.1x.25 02:30:00 bad digit, then 2026.10.25 02:59:59 a good one",
+    "2026.13.01 00:00:00 month out of range",
+    "2026.02.30 12:00:00 day out of range",
+    "2026.10.25 24:00:00 hour out of range",
+    "1999.12.31 23:59:59 before the checked years",
+    "x2026.03.08 02:15:00",
+};
+
+// Fields of the timestamp the old parser would find, if any
+std::optional<std::tm> findFields(const std::string& line) {
+    static const std::regex kLineTimePattern(R"((\d{4})\.(\d{2})\.(\d{2}) (\d{2}):(\d{2}):(\d{2}))");
+    std::smatch match;
+    if (!std::regex_search(line, match, kLineTimePattern)) {
+        return std::nullopt;
+    }
+    std::tm fields{};
+    fields.tm_year = std::stoi(match[1].str()) - 1900;
+    fields.tm_mon = std::stoi(match[2].str()) - 1;
+    fields.tm_mday = std::stoi(match[3].str());
+    fields.tm_hour = std::stoi(match[4].str());
+    fields.tm_min = std::stoi(match[5].str());
+    fields.tm_sec = std::stoi(match[6].str());
+    return fields;
+}
+
+enum class LocalTimeKind { Plain, Repeated, Skipped, None };
+
+struct Expected {
+    LocalTimeKind kind;
+    std::optional<TimePoint> instant;
+};
+
+// The instant a line's timestamp stands for, worked out independently of
+// parseLogTimestamp: the instants whose local reading equals the fields,
+// trying both tm_isdst values
+Expected expectedInstant(const std::string& line) {
+    std::optional<std::tm> fields = findFields(line);
+    if (!fields) {
+        return Expected{ LocalTimeKind::None, std::nullopt };
+    }
+    std::tm copy = *fields;
+    const std::time_t local = timegm(&copy);
+    std::vector<std::time_t> shown;
+    for (int isDst : { 0, 1 }) {
+        std::tm value = *fields;
+        value.tm_isdst = isDst;
+        std::time_t instant = std::mktime(&value);
+        std::tm back{};
+        if (instant != static_cast<std::time_t>(-1) && localtime_r(&instant, &back) && timegm(&back) == local
+            && std::find(shown.begin(), shown.end(), instant) == shown.end()) {
+            shown.push_back(instant);
+        }
+    }
+    if (shown.size() == 1) {
+        return Expected{ LocalTimeKind::Plain, std::chrono::system_clock::from_time_t(shown[0]) };
+    }
+    if (shown.size() == 2) {
+        return Expected{ LocalTimeKind::Repeated,
+                         std::chrono::system_clock::from_time_t(std::min(shown[0], shown[1])) };
+    }
+    std::time_t dayBefore = local - 86400;
+    std::tm before{};
+    localtime_r(&dayBefore, &before);
+    std::tm value = *fields;
+    value.tm_isdst = before.tm_isdst;
+    return Expected{ LocalTimeKind::Skipped, std::chrono::system_clock::from_time_t(std::mktime(&value)) };
+}
+
+struct Mismatch {
+    std::string zone;
+    std::string line;
+    std::optional<TimePoint> expected;
+    std::optional<TimePoint> actual;
+    std::optional<TimePoint> regex;
+};
+
+struct ZoneCounts {
+    uint64_t lines = 0;
+    uint64_t repeated = 0;
+    uint64_t skipped = 0;
+    uint64_t mismatches = 0;
+    uint64_t regexStrays = 0;
+};
+
+std::string describe(const std::optional<TimePoint>& value) {
+    if (!value) {
+        return "nullopt";
+    }
+    return std::to_string(std::chrono::system_clock::to_time_t(*value));
+}
+
+// The old parser runs first, so parseLogTimestamp sees glibc's mktime state
+// as the old parser left it, as in a log that was parsed by both
+void compareLines(const std::string& zone, const std::vector<std::string>& lines,
+                  ZoneCounts& counts, std::vector<Mismatch>& mismatches) {
+    for (const std::string& line : lines) {
+        std::optional<TimePoint> regex = extractLogTimestamp(line);
+        std::optional<TimePoint> actual = parseLogTimestamp(line);
+        Expected expected = expectedInstant(line);
+        counts.lines++;
+        counts.repeated += expected.kind == LocalTimeKind::Repeated;
+        counts.skipped += expected.kind == LocalTimeKind::Skipped;
+        counts.regexStrays += regex != expected.instant;
+        if (actual != expected.instant) {
+            counts.mismatches++;
+            mismatches.push_back(Mismatch{ zone, line, expected.instant, actual, regex });
+        }
+    }
+}
+
+// Keeps the compiler from discarding a parse whose result is unused
+std::atomic<int64_t> sink{ 0 };
+
+template <typename Parse>
+double nanosPerLine(const std::vector<std::string>& lines, Parse&& parse) {
+    auto t0 = std::chrono::steady_clock::now();
+    int64_t total = 0;
+    for (const std::string& line : lines) {
+        std::optional<TimePoint> value = parse(line);
+        total += value ? value->time_since_epoch().count() : 0;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    sink.fetch_add(total, std::memory_order_relaxed);
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / lines.size();
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " [--zone NAME]... [--bench-lines N]" << std::endl;
+        return 2;
+    }
+
+    std::mt19937 random(12345);
+    std::vector<Mismatch> mismatches;
+    uint64_t compared = 0;
+    uint64_t regexStrays = 0;
+    std::cout << "  " << std::left << std::setw(20) << "zone" << std::right << std::setw(12) << "transitions"
+              << std::setw(10) << "lines" << std::setw(10) << "repeated" << std::setw(10) << "skipped"
+              << std::setw(12) << "mismatches" << std::setw(14) << "regex strays" << "\n";
+    for (const std::string& zone : options.zones) {
+        setZone(zone);
+        std::vector<std::chrono::sys_days> days = transitionDays();
+        std::vector<std::string> lines = transitionLines(days);
+        ZoneCounts counts;
+        compareLines(zone, lines, counts, mismatches);
+        std::shuffle(lines.begin(), lines.end(), random);
+        compareLines(zone, lines, counts, mismatches);
+        compareLines(zone, std::vector<std::string>(std::begin(kEdgeLines), std::end(kEdgeLines)),
+                     counts, mismatches);
+        compared += counts.lines;
+        regexStrays += counts.regexStrays;
+        std::cout << "  " << std::left << std::setw(20) << zone << std::right << std::setw(12) << days.size()
+                  << std::setw(10) << counts.lines << std::setw(10) << counts.repeated
+                  << std::setw(10) << counts.skipped << std::setw(12) << counts.mismatches
+                  << std::setw(14) << counts.regexStrays << "\n";
+    }
+    for (size_t i = 0; i < mismatches.size() && i < 10; ++i) {
+        const Mismatch& mismatch = mismatches[i];
+        std::cout << "    " << mismatch.zone << " \"" << mismatch.line << "\": expected "
+                  << describe(mismatch.expected) << ", parseLogTimestamp " << describe(mismatch.actual)
+                  << ", regex " << describe(mismatch.regex) << "\n";
+    }
+    std::cout << "compared " << compared << " lines, " << mismatches.size() << " mismatches, regex strayed on "
+              << regexStrays << "\n";
+
+    // A log's worth of lines, a few seconds apart, in log order
+    setZone(options.zones.front());
+    std::vector<std::string> logLines;
+    std::chrono::sys_days day = std::chrono::year{ 2026 } / 3 / 27;
+    long second = 0;
+    for (long i = 0; i < options.benchLines; ++i) {
+        second += 1 + static_cast<long>(random() % 5);
+        logLines.push_back(logLine(day + std::chrono::days{ second / 86400 }, second % 86400,
+                                   "Log        -  [FishingSystem] Fish Pickup attached to rod Toggles(True)"));
+    }
+    double regexNs = nanosPerLine(logLines, [](const std::string& line) { return extractLogTimestamp(line); });
+    double parseNs = nanosPerLine(logLines, [](const std::string& line) { return parseLogTimestamp(line); });
+    std::cout << "per line (" << options.zones.front() << ", " << logLines.size() << " lines): regex "
+              << std::fixed << std::setprecision(0) << regexNs << " ns, parseLogTimestamp "
+              << std::setprecision(1) << parseNs << " ns, " << std::setprecision(0) << regexNs / parseNs << "x\n";
+
+    bool ok = mismatches.empty();
+    std::cout << (ok ? "OK" : "MISMATCH") << std::endl;
+    return ok ? 0 : 1;
+}